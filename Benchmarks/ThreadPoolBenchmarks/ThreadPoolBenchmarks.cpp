@@ -0,0 +1,319 @@
+// ThreadPoolBenchmarks.cpp : Google Benchmark suite for the thread library.
+// Results are written as JSON to ThreadPoolBenchmarks.json unless --benchmark_out is given.
+//
+
+#include "Job.h"
+#include "JobPool.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "ThreadWorker.h"
+
+#include "fmt/format.h"
+
+#include "benchmark/benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <optional>
+
+using namespace Utilities;
+using namespace Thread;
+
+namespace
+{
+	constexpr size_t JOBS_PER_ITERATION = 1000;
+	constexpr auto BENCHMARK_OUTPUT = "ThreadPoolBenchmarks.json";
+	constexpr auto SPILL_FOLDER = "ThreadPoolBenchmarks";
+
+	auto wait_for(const std::atomic<size_t>& counter, const size_t& target) -> void
+	{
+		while (counter.load(std::memory_order_acquire) < target)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	auto start_pool(const std::vector<std::vector<JobPriorities>>& workers, const std::optional<IdleStrategy>& strategy = std::nullopt)
+		-> std::shared_ptr<ThreadPool>
+	{
+		auto pool = std::make_shared<ThreadPool>("ThreadPoolBenchmarks");
+		if (strategy != std::nullopt)
+		{
+			for (auto priority : { JobPriorities::Top, JobPriorities::High, JobPriorities::Normal, JobPriorities::Low })
+			{
+				pool->idle_strategy(priority, strategy.value());
+			}
+		}
+
+		for (const auto& priorities : workers)
+		{
+			pool->push(std::make_shared<ThreadWorker>(priorities));
+		}
+
+		auto [started, start_error] = pool->start();
+		if (!started)
+		{
+			Logger::handle().write(LogTypes::Error, fmt::format("cannot start a benchmark pool : {}", start_error.value_or("unknown error")));
+
+			return nullptr;
+		}
+
+		return pool;
+	}
+
+	auto counting_job(const JobPriorities& priority, std::atomic<size_t>& completed) -> std::shared_ptr<Job>
+	{
+		return std::make_shared<Job>(priority,
+									 [&completed]() -> std::tuple<bool, std::optional<std::string>>
+									 {
+										 completed.fetch_add(1, std::memory_order_release);
+										 return { true, std::nullopt };
+									 });
+	}
+
+	auto latency_counters(benchmark::State& state, const std::string& name, const LatencySnapshot& snapshot) -> void
+	{
+		state.counters[name + "_p50_ns"] = static_cast<double>(snapshot.p50.count());
+		state.counters[name + "_p99_ns"] = static_cast<double>(snapshot.p99.count());
+		state.counters[name + "_p999_ns"] = static_cast<double>(snapshot.p999.count());
+	}
+} // namespace
+
+// pushes a burst of empty jobs and waits until every worker has drained it, so the score is pure scheduling overhead
+static void empty_job_throughput(benchmark::State& state)
+{
+	auto pool = start_pool(std::vector<std::vector<JobPriorities>>(static_cast<size_t>(state.range(0)), { JobPriorities::High }));
+	if (pool == nullptr)
+	{
+		state.SkipWithError("cannot start a benchmark pool");
+		return;
+	}
+
+	std::atomic<size_t> completed{ 0 };
+	size_t target = 0;
+
+	std::vector<std::shared_ptr<Job>> jobs;
+	jobs.reserve(JOBS_PER_ITERATION);
+
+	for (auto _ : state)
+	{
+		jobs.clear();
+		for (size_t index = 0; index < JOBS_PER_ITERATION; ++index)
+		{
+			jobs.push_back(counting_job(JobPriorities::High, completed));
+		}
+
+		pool->push(jobs);
+
+		target += JOBS_PER_ITERATION;
+		wait_for(completed, target);
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * JOBS_PER_ITERATION));
+
+	pool->stop();
+}
+BENCHMARK(empty_job_throughput)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+static std::shared_ptr<JobPool> shared_job_pool_;
+static std::unique_ptr<LatencyHistogram> push_pop_latency_;
+
+// every producer thread pushes one job and pops one back from the same lane, so all threads contend on one JobPool
+static void push_pop_latency(benchmark::State& state)
+{
+	if (state.thread_index() == 0)
+	{
+		shared_job_pool_ = std::make_shared<JobPool>("ThreadPoolBenchmarks");
+		push_pop_latency_ = std::make_unique<LatencyHistogram>();
+	}
+
+	const std::vector<JobPriorities> priorities{ JobPriorities::Normal };
+
+	for (auto _ : state)
+	{
+		auto job = std::make_shared<Job>(JobPriorities::Normal);
+
+		auto start_time = std::chrono::steady_clock::now();
+		shared_job_pool_->push(job);
+		auto popped = shared_job_pool_->pop(priorities);
+		push_pop_latency_->record(std::chrono::steady_clock::now() - start_time);
+
+		benchmark::DoNotOptimize(popped);
+	}
+
+	if (state.thread_index() == 0)
+	{
+		latency_counters(state, "push_pop", push_pop_latency_->snapshot());
+
+		shared_job_pool_.reset();
+		push_pop_latency_.reset();
+	}
+}
+BENCHMARK(push_pop_latency)->ThreadRange(1, 64)->UseRealTime();
+
+// High, Normal and Low jobs arrive interleaved on workers that serve all three, and the queue wait per priority shows how far Low is pushed back
+static void mixed_priority_fairness(benchmark::State& state)
+{
+	const std::vector<JobPriorities> priorities{ JobPriorities::High, JobPriorities::Normal, JobPriorities::Low };
+
+	auto pool = start_pool(std::vector<std::vector<JobPriorities>>(static_cast<size_t>(state.range(0)), priorities));
+	if (pool == nullptr)
+	{
+		state.SkipWithError("cannot start a benchmark pool");
+		return;
+	}
+
+	std::atomic<size_t> completed{ 0 };
+	size_t target = 0;
+
+	std::vector<std::shared_ptr<Job>> jobs;
+	jobs.reserve(JOBS_PER_ITERATION);
+
+	for (auto _ : state)
+	{
+		jobs.clear();
+		for (size_t index = 0; index < JOBS_PER_ITERATION; ++index)
+		{
+			jobs.push_back(counting_job(priorities[index % priorities.size()], completed));
+		}
+
+		pool->push(jobs);
+
+		target += JOBS_PER_ITERATION;
+		wait_for(completed, target);
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * JOBS_PER_ITERATION));
+
+	for (const auto& metrics : pool->metrics())
+	{
+		if (metrics.completed == 0)
+		{
+			continue;
+		}
+
+		latency_counters(state, priority_string(metrics.priority) + "_wait", metrics.queue_wait);
+	}
+
+	pool->stop();
+}
+BENCHMARK(mixed_priority_fairness)->Arg(1)->Arg(4)->UseRealTime();
+
+// the worker is left idle long enough to run out of spinning and park, then one job measures how long it takes to come back
+static void wakeup_latency(benchmark::State& state)
+{
+	auto pool = start_pool({ { JobPriorities::High } }, IdleStrategy{ static_cast<size_t>(state.range(0)), 0 });
+	if (pool == nullptr)
+	{
+		state.SkipWithError("cannot start a benchmark pool");
+		return;
+	}
+
+	const auto idle_time = std::chrono::microseconds(state.range(1));
+
+	std::atomic<size_t> completed{ 0 };
+	std::atomic<std::chrono::steady_clock::rep> woken_time{ 0 };
+	size_t target = 0;
+
+	for (auto _ : state)
+	{
+		std::this_thread::sleep_for(idle_time);
+
+		auto start_time = std::chrono::steady_clock::now();
+		pool->push(std::make_shared<Job>(JobPriorities::High,
+										 [&completed, &woken_time]() -> std::tuple<bool, std::optional<std::string>>
+										 {
+											 woken_time.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+											 completed.fetch_add(1, std::memory_order_release);
+											 return { true, std::nullopt };
+										 }));
+
+		wait_for(completed, ++target);
+
+		auto elapsed = std::chrono::steady_clock::duration(woken_time.load(std::memory_order_relaxed)) - start_time.time_since_epoch();
+		state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+	}
+
+	pool->stop();
+}
+BENCHMARK(wakeup_latency)->ArgNames({ "spin", "idle_us" })->ArgsProduct({ { 0, 1 << 16 }, { 50, 1000 } })->UseManualTime();
+
+// round trip of a payload through Job::save and the load that Job::work performs before calling back
+static void spill_cost(benchmark::State& state)
+{
+	std::vector<uint8_t> payload(static_cast<size_t>(state.range(0)), 0x5a);
+
+	for (auto _ : state)
+	{
+		auto job = std::make_shared<Job>(JobPriorities::Normal, payload,
+										 [](const std::vector<uint8_t>& data) -> std::tuple<bool, std::optional<std::string>>
+										 {
+											 benchmark::DoNotOptimize(data.data());
+											 return { !data.empty(), std::nullopt };
+										 });
+
+		auto [saved, save_error] = job->save(SPILL_FOLDER);
+		if (!saved)
+		{
+			state.SkipWithError(save_error.value_or("cannot save a job").c_str());
+			break;
+		}
+
+		auto [worked, work_error] = job->work();
+		if (!worked)
+		{
+			state.SkipWithError(work_error.value_or("cannot load a saved job").c_str());
+			break;
+		}
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * payload.size()));
+}
+BENCHMARK(spill_cost)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+auto main(int32_t argc, char* argv[]) -> int32_t
+{
+	std::string output_file = fmt::format("--benchmark_out={}", BENCHMARK_OUTPUT);
+	std::string output_format = "--benchmark_out_format=json";
+
+	std::vector<char*> arguments(argv, argv + argc);
+
+	bool has_output = false;
+	for (const auto& argument : arguments)
+	{
+		has_output |= (std::strncmp(argument, "--benchmark_out=", std::strlen("--benchmark_out=")) == 0);
+	}
+
+	if (!has_output)
+	{
+		arguments.push_back(output_file.data());
+		arguments.push_back(output_format.data());
+	}
+
+	auto count = static_cast<int32_t>(arguments.size());
+	arguments.push_back(nullptr);
+
+	benchmark::Initialize(&count, arguments.data());
+	if (benchmark::ReportUnrecognizedArguments(count, arguments.data()))
+	{
+		return 1;
+	}
+
+	// the logger has to run so the Debug lines written per job are drained instead of piling up in memory
+	Logger::handle().file_mode(LogTypes::None);
+	Logger::handle().console_mode(LogTypes::None);
+	Logger::handle().start("ThreadPoolBenchmarks");
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	Logger::handle().stop();
+	Logger::destroy();
+
+	return 0;
+}
@@ -33,6 +33,9 @@ namespace Network
 		, buffer_size_(1024)
 		, receiving_buffers_(nullptr)
 		, thread_pool_(nullptr)
+		, job_recycler_(std::make_shared<JobRecycler<Job>>())
+		, sending_job_recycler_(std::make_shared<JobRecycler<SendingJob>>())
+		, receiving_job_recycler_(std::make_shared<JobRecycler<ReceivingJob>>())
 #ifdef USE_ENCRYPT_MODULE
 		, encrypt_mode_(false)
 		, key_("")
@@ -341,14 +344,17 @@ namespace Network
 		if (mode == DataModes::Connection)
 		{
 			return thread_pool_->push(
-				std::make_shared<Job>(JobPriorities::High, sending_data, std::bind(&DataHandler::compress_message, this, std::placeholders::_1), "compress_message"));
+				job_recycler_->acquire(JobPriorities::High, sending_data, [this](const std::vector<uint8_t>& target) { return compress_message(target); },
+									   "compress_message"));
 		}
 
 		return thread_pool_->push(
-			std::make_shared<Job>(JobPriorities::Normal, sending_data, std::bind(&DataHandler::encrypt_message, this, std::placeholders::_1), "encrypt_message"));
+			job_recycler_->acquire(JobPriorities::Normal, sending_data, [this](const std::vector<uint8_t>& target) { return encrypt_message(target); },
+								   "encrypt_message"));
 #else
 		return thread_pool_->push(
-			std::make_shared<Job>(JobPriorities::High, sending_data, std::bind(&DataHandler::compress_message, this, std::placeholders::_1), "compress_message"));
+			job_recycler_->acquire(JobPriorities::High, sending_data, [this](const std::vector<uint8_t>& target) { return compress_message(target); },
+								   "compress_message"));
 #endif
 	}
 
@@ -577,8 +583,8 @@ namespace Network
 
 			if (thread_pool_ != nullptr)
 			{
-				thread_pool_->push(std::make_shared<Job>(JobPriorities::Low, received_data_, std::bind(&DataHandler::decompress_message, this, std::placeholders::_1),
-														 "decompress_message"));
+				thread_pool_->push(job_recycler_->acquire(
+					JobPriorities::Low, received_data_, [this](const std::vector<uint8_t>& target) { return decompress_message(target); }, "decompress_message"));
 			}
 
 			received_data_.clear();
@@ -656,7 +662,7 @@ namespace Network
 			buffer = data;
 		}
 
-		return thread_pool_->push(std::dynamic_pointer_cast<Job>(std::make_shared<SendingJob>(socket_, start_code_tag_, buffer.value(), end_code_tag_, buffer_size_)));
+		return thread_pool_->push(std::dynamic_pointer_cast<Job>(sending_job_recycler_->acquire(socket_, start_code_tag_, buffer.value(), end_code_tag_, buffer_size_)));
 	}
 
 	auto DataHandler::decompress_message(const std::vector<uint8_t>& data) -> std::tuple<bool, std::optional<std::string>>
@@ -679,10 +685,11 @@ namespace Network
 
 #ifdef USE_ENCRYPT_MODULE
 		return thread_pool_->push(
-			std::make_shared<Job>(JobPriorities::Normal, buffer.value(), std::bind(&DataHandler::decrypt_message, this, std::placeholders::_1), "decrypt_message"));
+			job_recycler_->acquire(JobPriorities::Normal, buffer.value(), [this](const std::vector<uint8_t>& target) { return decrypt_message(target); },
+								   "decrypt_message"));
 #else
 		return thread_pool_->push(std::dynamic_pointer_cast<Job>(
-			std::make_shared<ReceivingJob>(buffer.value(), std::bind(&DataHandler::received_data, this, std::placeholders::_1, std::placeholders::_2))));
+			receiving_job_recycler_->acquire(buffer.value(), [this](const DataModes& mode, const std::vector<uint8_t>& target) { return received_data(mode, target); })));
 #endif
 	}
 
@@ -702,7 +709,7 @@ namespace Network
 		if (!encrypt_mode_)
 		{
 			return thread_pool_->push(
-				std::make_shared<Job>(JobPriorities::High, data, std::bind(&DataHandler::compress_message, this, std::placeholders::_1), "compress_message"));
+				job_recycler_->acquire(JobPriorities::High, data, [this](const std::vector<uint8_t>& target) { return compress_message(target); }, "compress_message"));
 		}
 
 		auto [buffer, message] = Encryptor::encryption(data, key(), iv());
@@ -712,7 +719,8 @@ namespace Network
 		}
 
 		return thread_pool_->push(
-			std::make_shared<Job>(JobPriorities::High, buffer.value(), std::bind(&DataHandler::compress_message, this, std::placeholders::_1), "compress_message"));
+			job_recycler_->acquire(JobPriorities::High, buffer.value(), [this](const std::vector<uint8_t>& target) { return compress_message(target); },
+								   "compress_message"));
 	}
 
 	auto DataHandler::decrypt_message(const std::vector<uint8_t>& data) -> std::tuple<bool, std::optional<std::string>>
@@ -730,7 +738,7 @@ namespace Network
 		if (!encrypt_mode_)
 		{
 			return thread_pool_->push(std::dynamic_pointer_cast<Job>(
-				std::make_shared<ReceivingJob>(data, std::bind(&DataHandler::received_data, this, std::placeholders::_1, std::placeholders::_2))));
+				receiving_job_recycler_->acquire(data, [this](const DataModes& mode, const std::vector<uint8_t>& target) { return received_data(mode, target); })));
 		}
 
 		auto [buffer, message] = Encryptor::decryption(data, key(), iv());
@@ -740,7 +748,7 @@ namespace Network
 		}
 
 		return thread_pool_->push(std::dynamic_pointer_cast<Job>(
-			std::make_shared<ReceivingJob>(buffer.value(), std::bind(&DataHandler::received_data, this, std::placeholders::_1, std::placeholders::_2))));
+			receiving_job_recycler_->acquire(buffer.value(), [this](const DataModes& mode, const std::vector<uint8_t>& target) { return received_data(mode, target); })));
 	}
 #endif
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "DataModes.h"
 #include "ThreadPool.h"
+#include "JobRecycler.h"
 #include "JobPriorities.h"
 #include "ConnectConditions.h"
 
@@ -14,6 +15,8 @@ using namespace Thread;
 
 namespace Network
 {
+	class SendingJob;
+	class ReceivingJob;
 	class DataHandler
 	{
 	public:
@@ -108,6 +111,9 @@ namespace Network
 #endif
 
 		std::shared_ptr<ThreadPool> thread_pool_;
+		std::shared_ptr<JobRecycler<Job>> job_recycler_;
+		std::shared_ptr<JobRecycler<SendingJob>> sending_job_recycler_;
+		std::shared_ptr<JobRecycler<ReceivingJob>> receiving_job_recycler_;
 		std::shared_ptr<boost::asio::ip::tcp::socket> socket_;
 
 		uint8_t* receiving_buffers_;
@@ -20,6 +20,22 @@ namespace Network
 
 	ReceivingJob::~ReceivingJob(void) {}
 
+	auto ReceivingJob::reset(const std::vector<uint8_t>& data,
+							 const std::function<std::tuple<bool, std::optional<std::string>>(
+								 const DataModes&, const std::vector<uint8_t>&)>& callback) -> void
+	{
+		Job::reset(JobPriorities::High, data, "ReceivingJob");
+
+		receiving_callback_ = callback;
+	}
+
+	auto ReceivingJob::recycle(void) -> void
+	{
+		Job::recycle();
+
+		receiving_callback_ = nullptr;
+	}
+
 	auto ReceivingJob::working(void) -> std::tuple<bool, std::optional<std::string>>
 	{
 		if (receiving_callback_ == nullptr)
@@ -27,7 +43,7 @@ namespace Network
 			return { false, "cannot complete ReceivingJob with null callback" };
 		}
 
-		auto data = get_data();
+		const auto& data = get_data();
 		if (data.empty())
 		{
 			return { false, "cannot complete ReceivingJob with null data" };
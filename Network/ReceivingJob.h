@@ -15,6 +15,11 @@ namespace Network
 						 const DataModes&, const std::vector<uint8_t>&)>& callback);
 		virtual ~ReceivingJob(void);
 
+		auto reset(const std::vector<uint8_t>& data,
+				   const std::function<std::tuple<bool, std::optional<std::string>>(
+					   const DataModes&, const std::vector<uint8_t>&)>& callback) -> void;
+		auto recycle(void) -> void override;
+
 	private:
 		auto working(void) -> std::tuple<bool, std::optional<std::string>> override;
 
@@ -28,9 +28,30 @@ namespace Network
 
 	SendingJob::~SendingJob(void) {}
 
+	auto SendingJob::reset(std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+						   const std::vector<uint8_t>& start_code,
+						   const std::vector<uint8_t>& data,
+						   const std::vector<uint8_t>& end_code,
+						   const size_t& buffer_size) -> void
+	{
+		Job::reset(JobPriorities::Top, data, "SendingJob");
+
+		socket_ = socket;
+		start_code_ = start_code;
+		end_code_ = end_code;
+		buffer_size_ = buffer_size;
+	}
+
+	auto SendingJob::recycle(void) -> void
+	{
+		Job::recycle();
+
+		socket_.reset();
+	}
+
 	auto SendingJob::working(void) -> std::tuple<bool, std::optional<std::string>>
 	{
-		std::vector<uint8_t> data = get_data();
+		const auto& data = get_data();
 		if (data.empty())
 		{
 			return { false, "cannot send to empty data" };
@@ -117,8 +138,7 @@ namespace Network
 		{
 			temp = std::min(buffer_size_, count - index);
 
-			std::vector<uint8_t> temp_buffer(data.begin() + index, data.begin() + index + temp);
-			temp = socket_->send(boost::asio::buffer(temp_buffer.data(), temp));
+			temp = socket_->send(boost::asio::buffer(data.data() + index, temp));
 			if (temp == 0)
 			{
 				return { false, fmt::format("cannot send data: sent [{}] / total [{}] bytes", temp, count) };
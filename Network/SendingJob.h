@@ -18,6 +18,13 @@ namespace Network
 				   const size_t& buffer_size);
 		virtual ~SendingJob(void);
 
+		auto reset(std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+				   const std::vector<uint8_t>& start_code,
+				   const std::vector<uint8_t>& data,
+				   const std::vector<uint8_t>& end_code,
+				   const size_t& buffer_size) -> void;
+		auto recycle(void) -> void override;
+
 	private:
 		auto working(void) -> std::tuple<bool, std::optional<std::string>> override;
 
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Thread
+{
+	enum class AffinityModes : uint8_t { None, CoreSet, SpreadNodes, Colocate };
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Thread
+{
+	enum class BackpressurePolicies : uint8_t { Block, Reject, DropOldest, Spill };
+}
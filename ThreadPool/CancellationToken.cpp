@@ -0,0 +1,20 @@
+#include "CancellationToken.h"
+
+namespace Thread
+{
+	CancellationToken::CancellationToken(std::shared_ptr<CancellationToken> parent) : cancelled_(false), parent_(parent) {}
+
+	CancellationToken::~CancellationToken(void) {}
+
+	auto CancellationToken::cancel(void) -> void { cancelled_.store(true, std::memory_order_release); }
+
+	auto CancellationToken::cancelled(void) const -> bool
+	{
+		if (cancelled_.load(std::memory_order_acquire))
+		{
+			return true;
+		}
+
+		return parent_ != nullptr && parent_->cancelled();
+	}
+} // namespace Thread
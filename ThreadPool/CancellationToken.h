@@ -0,0 +1,24 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace Thread
+{
+	// Shared cancellation flag for request-scoped work.
+	// The same token can be attached to many jobs; once cancelled, JobPool discards those jobs at pop time
+	// and a running job can poll cancelled() to stop early. A token created from a parent is cancelled with it.
+	class CancellationToken
+	{
+	public:
+		CancellationToken(std::shared_ptr<CancellationToken> parent = nullptr);
+		virtual ~CancellationToken(void);
+
+		auto cancel(void) -> void;
+		auto cancelled(void) const -> bool;
+
+	private:
+		std::atomic_bool cancelled_;
+		std::shared_ptr<CancellationToken> parent_;
+	};
+} // namespace Thread
@@ -0,0 +1,123 @@
+#include "Coroutine.h"
+
+#include "ThreadPool.h"
+
+#include <utility>
+#include <stdexcept>
+
+namespace Thread
+{
+	namespace
+	{
+		// the awaiter whose await_suspend is still on this thread's stack, so a hop rejected inside push is not resumed twice
+		thread_local const std::optional<std::string>* suspending_ = nullptr;
+
+		// the innermost DeferredResumes open on this thread
+		thread_local DeferredResumes* deferred_ = nullptr;
+
+		// Owns the suspended frame while the hop is queued.
+		// A hop that is discarded without running resumes the coroutine with an error, so its Future still completes;
+		// inside a DeferredResumes scope that resume waits until the scope closes.
+		class ScheduledResume
+		{
+		public:
+			ScheduledResume(std::coroutine_handle<> handle, std::optional<std::string>* error_message) : handle_(handle), error_message_(error_message) {}
+
+			ScheduledResume(ScheduledResume&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)), error_message_(other.error_message_) {}
+
+			ScheduledResume(const ScheduledResume&) = delete;
+			ScheduledResume& operator=(const ScheduledResume&) = delete;
+			ScheduledResume& operator=(ScheduledResume&&) = delete;
+
+			~ScheduledResume(void)
+			{
+				if (!handle_)
+				{
+					return;
+				}
+
+				*error_message_ = "the scheduled coroutine was discarded before it could run";
+
+				// await_suspend reports the rejection itself by returning false
+				if (suspending_ == error_message_)
+				{
+					return;
+				}
+
+				auto handle = std::exchange(handle_, nullptr);
+				if (DeferredResumes::defer(handle))
+				{
+					return;
+				}
+
+				handle.resume();
+			}
+
+			auto operator()(void) -> void { std::exchange(handle_, nullptr).resume(); }
+
+		private:
+			std::coroutine_handle<> handle_;
+			std::optional<std::string>* error_message_;
+		};
+	} // namespace
+
+	DeferredResumes::DeferredResumes(void) : previous_(std::exchange(deferred_, this)) {}
+
+	DeferredResumes::~DeferredResumes(void)
+	{
+		deferred_ = previous_;
+
+		// a resumed coroutine may discard further hops, which then land in the enclosing scope or run at once
+		for (auto& handle : handles_)
+		{
+			handle.resume();
+		}
+	}
+
+	auto DeferredResumes::defer(std::coroutine_handle<> handle) -> bool
+	{
+		if (deferred_ == nullptr)
+		{
+			return false;
+		}
+
+		deferred_->handles_.push_back(handle);
+
+		return true;
+	}
+
+	ScheduleAwaiter::ScheduleAwaiter(ThreadPool* pool, const JobPriorities& priority) : pool_(pool), priority_(priority), error_message_(std::nullopt) {}
+
+	auto ScheduleAwaiter::await_suspend(std::coroutine_handle<> handle) -> bool
+	{
+		if (pool_ == nullptr)
+		{
+			error_message_ = "cannot schedule a coroutine on null ThreadPool";
+
+			return false;
+		}
+
+		// this awaiter lives in the coroutine frame, which a worker may resume and free before push returns
+		auto priority = priority_;
+		auto previous = std::exchange(suspending_, &error_message_);
+		auto [pushed, message] = pool_->push(priority, Task(ScheduledResume(handle, &error_message_)));
+		suspending_ = previous;
+
+		if (!pushed)
+		{
+			error_message_ = message.value_or("cannot schedule a coroutine");
+
+			return false;
+		}
+
+		return true;
+	}
+
+	auto ScheduleAwaiter::await_resume(void) -> void
+	{
+		if (error_message_.has_value())
+		{
+			throw std::runtime_error(error_message_.value());
+		}
+	}
+} // namespace Thread
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "Future.h"
+#include "JobPriorities.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <exception>
+#include <coroutine>
+
+namespace Thread
+{
+	class ThreadPool;
+
+	// Awaiting it suspends the coroutine and resumes it on a ThreadWorker serving the priority.
+	// A hop costs one Task in the lock-free lane instead of a heap-allocated Job.
+	class ScheduleAwaiter
+	{
+	public:
+		ScheduleAwaiter(ThreadPool* pool, const JobPriorities& priority);
+
+		auto await_ready(void) const noexcept -> bool { return false; }
+		auto await_suspend(std::coroutine_handle<> handle) -> bool;
+		auto await_resume(void) -> void;
+
+	private:
+		ThreadPool* pool_;
+		JobPriorities priority_;
+		std::optional<std::string> error_message_;
+	};
+
+	// While one is open on a thread, coroutines whose hop is discarded there are resumed when it closes instead of at once.
+	// ThreadPool opens one around the calls that drop queued hops under its own lock, so no coroutine body runs inside them.
+	class DeferredResumes
+	{
+	public:
+		DeferredResumes(void);
+		~DeferredResumes(void);
+
+		DeferredResumes(const DeferredResumes&) = delete;
+		DeferredResumes& operator=(const DeferredResumes&) = delete;
+
+		static auto defer(std::coroutine_handle<> handle) -> bool;
+
+	private:
+		DeferredResumes* previous_;
+		std::vector<std::coroutine_handle<>> handles_;
+	};
+
+	template <typename T> class Coroutine;
+
+	class CoroutinePromiseBase
+	{
+	public:
+		struct FinalAwaiter
+		{
+			auto await_ready(void) const noexcept -> bool { return false; }
+
+			template <typename Promise> auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> std::coroutine_handle<>
+			{
+				auto continuation = handle.promise().continuation_;
+				if (continuation)
+				{
+					return continuation;
+				}
+
+				return std::noop_coroutine();
+			}
+
+			auto await_resume(void) noexcept -> void {}
+		};
+
+		auto initial_suspend(void) noexcept -> std::suspend_always { return {}; }
+		auto final_suspend(void) noexcept -> FinalAwaiter { return {}; }
+
+		auto unhandled_exception(void) -> void { exception_ = std::current_exception(); }
+
+		auto continuation(std::coroutine_handle<> handle) -> void { continuation_ = handle; }
+
+	protected:
+		auto rethrow_if_failed(void) -> void
+		{
+			if (exception_ != nullptr)
+			{
+				std::rethrow_exception(exception_);
+			}
+		}
+
+	private:
+		std::coroutine_handle<> continuation_;
+		std::exception_ptr exception_;
+	};
+
+	template <typename T> class CoroutinePromise : public CoroutinePromiseBase
+	{
+	public:
+		auto get_return_object(void) -> Coroutine<T>;
+
+		template <typename U> auto return_value(U&& value) -> void { value_.emplace(std::forward<U>(value)); }
+
+		auto result(void) -> T
+		{
+			rethrow_if_failed();
+
+			return std::move(value_.value());
+		}
+
+	private:
+		std::optional<T> value_;
+	};
+
+	template <> class CoroutinePromise<void> : public CoroutinePromiseBase
+	{
+	public:
+		auto get_return_object(void) -> Coroutine<void>;
+
+		auto return_void(void) -> void {}
+
+		auto result(void) -> void { rethrow_if_failed(); }
+	};
+
+	// Lazily started coroutine returning T.
+	// co_await it from another coroutine to run it and continue with its result,
+	// or call start() from plain code to launch it and receive a Future<T>.
+	template <typename T> class Coroutine
+	{
+	public:
+		using promise_type = CoroutinePromise<T>;
+
+		Coroutine(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+		Coroutine(Coroutine&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+		Coroutine& operator=(Coroutine&& other) noexcept
+		{
+			if (this != &other)
+			{
+				if (handle_)
+				{
+					handle_.destroy();
+				}
+
+				handle_ = std::exchange(other.handle_, nullptr);
+			}
+
+			return *this;
+		}
+
+		Coroutine(const Coroutine&) = delete;
+		Coroutine& operator=(const Coroutine&) = delete;
+
+		virtual ~Coroutine(void)
+		{
+			if (handle_)
+			{
+				handle_.destroy();
+			}
+		}
+
+		auto await_ready(void) const noexcept -> bool { return !handle_ || handle_.done(); }
+
+		auto await_suspend(std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<>
+		{
+			handle_.promise().continuation(awaiting);
+
+			return handle_;
+		}
+
+		auto await_resume(void) -> T { return handle_.promise().result(); }
+
+		auto start(void) -> Future<T>;
+
+	private:
+		std::coroutine_handle<promise_type> handle_;
+	};
+
+	template <typename T> auto CoroutinePromise<T>::get_return_object(void) -> Coroutine<T>
+	{
+		return Coroutine<T>(std::coroutine_handle<CoroutinePromise<T>>::from_promise(*this));
+	}
+
+	inline auto CoroutinePromise<void>::get_return_object(void) -> Coroutine<void>
+	{
+		return Coroutine<void>(std::coroutine_handle<CoroutinePromise<void>>::from_promise(*this));
+	}
+
+	// Fire-and-forget frame used by Coroutine::start(); it frees itself when it finishes.
+	struct DetachedCoroutine
+	{
+		struct promise_type
+		{
+			auto get_return_object(void) -> DetachedCoroutine { return {}; }
+			auto initial_suspend(void) noexcept -> std::suspend_never { return {}; }
+			auto final_suspend(void) noexcept -> std::suspend_never { return {}; }
+			auto return_void(void) -> void {}
+			auto unhandled_exception(void) -> void { std::terminate(); }
+		};
+	};
+
+	template <typename T> auto run_detached(Coroutine<T> coroutine, Promise<T> promise) -> DetachedCoroutine
+	{
+		std::exception_ptr exception = nullptr;
+		try
+		{
+			if constexpr (std::is_void_v<T>)
+			{
+				co_await coroutine;
+				promise.set_value();
+			}
+			else
+			{
+				promise.set_value(co_await coroutine);
+			}
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		if (exception != nullptr)
+		{
+			promise.set_exception(exception);
+		}
+	}
+
+	template <typename T> auto Coroutine<T>::start(void) -> Future<T>
+	{
+		Promise<T> promise;
+		auto future = promise.get_future();
+
+		run_detached(std::move(*this), std::move(promise));
+
+		return future;
+	}
+} // namespace Thread
@@ -0,0 +1,250 @@
+#include "CpuTopology.h"
+
+#include "Converter.h"
+
+#include <map>
+#include <cctype>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <pthread.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace Utilities;
+
+namespace Thread
+{
+	CpuTopology::CpuTopology(void) { load(); }
+
+	CpuTopology::~CpuTopology(void) {}
+
+	auto CpuTopology::node_count(void) const -> size_t { return node_cores_.size(); }
+
+	auto CpuTopology::cores(const size_t& node) const -> std::vector<size_t>
+	{
+		if (node >= node_cores_.size())
+		{
+			return {};
+		}
+
+		return node_cores_[node];
+	}
+
+	auto CpuTopology::node(const size_t& core) const -> size_t
+	{
+		if (core >= core_nodes_.size())
+		{
+			return 0;
+		}
+
+		return core_nodes_[core];
+	}
+
+	auto CpuTopology::current_node(void) const -> size_t
+	{
+		auto core = current_core();
+		if (core == std::nullopt)
+		{
+			return 0;
+		}
+
+		return node(core.value());
+	}
+
+	auto CpuTopology::colocated(void) const -> AffinityPolicy { return { AffinityModes::Colocate, cores(current_node()) }; }
+
+	auto CpuTopology::placement(const AffinityPolicy& policy, const size_t& worker_index) const -> std::vector<size_t>
+	{
+		switch (policy.mode)
+		{
+		case AffinityModes::CoreSet:
+		case AffinityModes::Colocate:
+			return policy.cores;
+		case AffinityModes::SpreadNodes:
+			return cores(worker_index % node_cores_.size());
+		default:
+			return {};
+		}
+	}
+
+	auto CpuTopology::current_core(void) -> std::optional<size_t>
+	{
+#if defined(__linux__)
+		auto core = sched_getcpu();
+		if (core < 0)
+		{
+			return std::nullopt;
+		}
+
+		return static_cast<size_t>(core);
+#elif defined(_WIN32)
+		return static_cast<size_t>(GetCurrentProcessorNumber());
+#else
+		return std::nullopt;
+#endif
+	}
+
+	auto CpuTopology::pin(const std::vector<size_t>& cores) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (cores.empty())
+		{
+			return { false, "cannot pin a thread to empty cores" };
+		}
+
+#if defined(__linux__)
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		for (const auto& core : cores)
+		{
+			if (core < CPU_SETSIZE)
+			{
+				CPU_SET(core, &cpu_set);
+			}
+		}
+
+		auto result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+		if (result != 0)
+		{
+			return { false, "cannot set thread affinity : " + std::to_string(result) };
+		}
+
+		return { true, std::nullopt };
+#elif defined(_WIN32)
+		DWORD_PTR mask = 0;
+		for (const auto& core : cores)
+		{
+			if (core < sizeof(DWORD_PTR) * 8)
+			{
+				mask |= (static_cast<DWORD_PTR>(1) << core);
+			}
+		}
+
+		if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+		{
+			return { false, "cannot set thread affinity : " + std::to_string(GetLastError()) };
+		}
+
+		return { true, std::nullopt };
+#else
+		return { false, "thread affinity is not supported on this platform" };
+#endif
+	}
+
+	auto CpuTopology::load(void) -> void
+	{
+		std::error_code ec;
+		const std::filesystem::path root("/sys/devices/system/node");
+
+		// node ids can be sparse after hot-unplug or on some firmware, so the directory is listed instead of counting up from node0
+		std::map<size_t, std::filesystem::path> nodes;
+		std::filesystem::directory_iterator iterator(root, ec), endItr;
+		for (; !ec && iterator != endItr; iterator.increment(ec))
+		{
+			auto name = iterator->path().filename().string();
+			if (name.size() <= 4 || name.compare(0, 4, "node") != 0)
+			{
+				continue;
+			}
+
+			if (!std::all_of(name.begin() + 4, name.end(), [](const char& value) { return std::isdigit(static_cast<unsigned char>(value)) != 0; }))
+			{
+				continue;
+			}
+
+			try
+			{
+				nodes.insert({ std::stoul(name.substr(4)), iterator->path() });
+			}
+			catch (...)
+			{
+				continue;
+			}
+		}
+
+		for (const auto& [id, path] : nodes)
+		{
+			std::ifstream source(path / "cpulist");
+
+			std::string line;
+			std::getline(source, line);
+
+			node_cores_.push_back(parse_list(line));
+		}
+
+		// a memory-only node has no cores and would never run a worker
+		node_cores_.erase(std::remove_if(node_cores_.begin(), node_cores_.end(), [](const std::vector<size_t>& cores) { return cores.empty(); }),
+						  node_cores_.end());
+
+		if (node_cores_.empty())
+		{
+			std::vector<size_t> all_cores(std::max(std::thread::hardware_concurrency(), 1u));
+			for (size_t core = 0; core < all_cores.size(); ++core)
+			{
+				all_cores[core] = core;
+			}
+
+			node_cores_.push_back(all_cores);
+		}
+
+		for (size_t node = 0; node < node_cores_.size(); ++node)
+		{
+			for (const auto& core : node_cores_[node])
+			{
+				if (core >= core_nodes_.size())
+				{
+					core_nodes_.resize(core + 1, 0);
+				}
+
+				core_nodes_[core] = node;
+			}
+		}
+	}
+
+	auto CpuTopology::parse_list(const std::string& source) const -> std::vector<size_t>
+	{
+		std::vector<size_t> result;
+
+		for (auto& range : Converter::split(source, ","))
+		{
+			auto bounds = Converter::split(range, "-");
+			if (bounds.empty() || bounds.front().empty())
+			{
+				continue;
+			}
+
+			try
+			{
+				auto first = std::stoul(bounds.front());
+				auto last = (bounds.size() > 1) ? std::stoul(bounds.back()) : first;
+				for (auto core = first; core <= last; ++core)
+				{
+					result.push_back(core);
+				}
+			}
+			catch (...)
+			{
+				continue;
+			}
+		}
+
+		return result;
+	}
+
+#pragma region Handle
+	std::unique_ptr<CpuTopology> CpuTopology::handle_;
+	std::once_flag CpuTopology::once_;
+
+	CpuTopology& CpuTopology::handle(void)
+	{
+		std::call_once(once_, []() { handle_.reset(new CpuTopology); });
+
+		return *handle_.get();
+	}
+#pragma endregion
+} // namespace Thread
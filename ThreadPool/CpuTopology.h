@@ -0,0 +1,58 @@
+#pragma once
+
+#include "AffinityModes.h"
+
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace Thread
+{
+	struct AffinityPolicy
+	{
+		AffinityModes mode;
+		std::vector<size_t> cores;
+	};
+
+	// NUMA layout of the machine, read once from /sys/devices/system/node on Linux.
+	// Other platforms, and machines without that tree, are seen as a single node holding every core.
+	class CpuTopology
+	{
+	private:
+		CpuTopology(void);
+
+	public:
+		virtual ~CpuTopology(void);
+
+		auto node_count(void) const -> size_t;
+		auto cores(const size_t& node) const -> std::vector<size_t>;
+		auto node(const size_t& core) const -> size_t;
+
+		auto current_node(void) const -> size_t;
+		auto colocated(void) const -> AffinityPolicy;
+		auto placement(const AffinityPolicy& policy, const size_t& worker_index) const -> std::vector<size_t>;
+
+		static auto current_core(void) -> std::optional<size_t>;
+		static auto pin(const std::vector<size_t>& cores) -> std::tuple<bool, std::optional<std::string>>;
+
+	private:
+		auto load(void) -> void;
+		auto parse_list(const std::string& source) const -> std::vector<size_t>;
+
+	private:
+		std::vector<size_t> core_nodes_;
+		std::vector<std::vector<size_t>> node_cores_;
+
+#pragma region Handle
+	public:
+		static CpuTopology& handle(void);
+
+	private:
+		static std::unique_ptr<CpuTopology> handle_;
+		static std::once_flag once_;
+#pragma endregion
+	};
+} // namespace Thread
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <future>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+namespace Thread
+{
+	template <typename T> class Future;
+	template <typename T> class Promise;
+
+	// Single allocation shared between a Promise and its Future.
+	// Continuations registered through on_ready() run on the thread that completes the state,
+	// which is how when_all/when_any join without parking a thread per input.
+	template <typename T> class SharedState
+	{
+	public:
+		using Storage = std::conditional_t<std::is_void_v<T>, bool, T>;
+
+		SharedState(void) : ready_(false), exception_(nullptr) {}
+
+		auto set_value(Storage&& value) -> bool
+		{
+			std::vector<std::function<void(void)>> continuations;
+			{
+				std::scoped_lock<std::mutex> lock(mutex_);
+				if (ready_)
+				{
+					return false;
+				}
+
+				value_.emplace(std::move(value));
+				ready_ = true;
+				continuations.swap(continuations_);
+			}
+
+			complete(continuations);
+
+			return true;
+		}
+
+		auto set_exception(std::exception_ptr exception) -> bool
+		{
+			std::vector<std::function<void(void)>> continuations;
+			{
+				std::scoped_lock<std::mutex> lock(mutex_);
+				if (ready_)
+				{
+					return false;
+				}
+
+				exception_ = exception;
+				ready_ = true;
+				continuations.swap(continuations_);
+			}
+
+			complete(continuations);
+
+			return true;
+		}
+
+		auto on_ready(std::function<void(void)> continuation) -> void
+		{
+			{
+				std::scoped_lock<std::mutex> lock(mutex_);
+				if (!ready_)
+				{
+					continuations_.push_back(std::move(continuation));
+
+					return;
+				}
+			}
+
+			continuation();
+		}
+
+		auto ready(void) -> bool
+		{
+			std::scoped_lock<std::mutex> lock(mutex_);
+
+			return ready_;
+		}
+
+		auto wait(void) -> void
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return ready_; });
+		}
+
+		template <typename Rep, typename Period> auto wait_for(const std::chrono::duration<Rep, Period>& timeout) -> bool
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			return condition_.wait_for(lock, timeout, [this]() { return ready_; });
+		}
+
+		auto exception(void) -> std::exception_ptr
+		{
+			std::scoped_lock<std::mutex> lock(mutex_);
+
+			return exception_;
+		}
+
+		auto take(void) -> Storage
+		{
+			wait();
+
+			std::scoped_lock<std::mutex> lock(mutex_);
+			if (exception_ != nullptr)
+			{
+				std::rethrow_exception(exception_);
+			}
+
+			return std::move(value_.value());
+		}
+
+	private:
+		auto complete(std::vector<std::function<void(void)>>& continuations) -> void
+		{
+			{
+				std::scoped_lock<std::mutex> lock(mutex_);
+				condition_.notify_all();
+			}
+
+			for (auto& continuation : continuations)
+			{
+				continuation();
+			}
+		}
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable condition_;
+
+		bool ready_;
+		std::optional<Storage> value_;
+		std::exception_ptr exception_;
+		std::vector<std::function<void(void)>> continuations_;
+	};
+
+	template <typename T> class Future
+	{
+	public:
+		Future(void) : state_(nullptr) {}
+		Future(std::shared_ptr<SharedState<T>> state) : state_(state) {}
+
+		Future(Future&&) noexcept = default;
+		Future& operator=(Future&&) noexcept = default;
+
+		Future(const Future&) = delete;
+		Future& operator=(const Future&) = delete;
+
+		auto valid(void) const -> bool { return state_ != nullptr; }
+
+		auto ready(void) const -> bool { return state_ != nullptr && state_->ready(); }
+
+		auto wait(void) const -> void
+		{
+			if (state_ == nullptr)
+			{
+				throw std::future_error(std::future_errc::no_state);
+			}
+
+			state_->wait();
+		}
+
+		template <typename Rep, typename Period> auto wait_for(const std::chrono::duration<Rep, Period>& timeout) const -> bool
+		{
+			if (state_ == nullptr)
+			{
+				throw std::future_error(std::future_errc::no_state);
+			}
+
+			return state_->wait_for(timeout);
+		}
+
+		auto get(void) -> T
+		{
+			if (state_ == nullptr)
+			{
+				throw std::future_error(std::future_errc::no_state);
+			}
+
+			auto state = std::move(state_);
+			if constexpr (std::is_void_v<T>)
+			{
+				state->take();
+			}
+			else
+			{
+				return state->take();
+			}
+		}
+
+		auto state(void) const -> std::shared_ptr<SharedState<T>> { return state_; }
+
+		static auto exceptional(std::exception_ptr exception) -> Future<T>
+		{
+			auto state = std::make_shared<SharedState<T>>();
+			state->set_exception(exception);
+
+			return Future<T>(state);
+		}
+
+	private:
+		std::shared_ptr<SharedState<T>> state_;
+	};
+
+	template <typename T> class Promise
+	{
+	public:
+		Promise(void) : state_(std::make_shared<SharedState<T>>()) {}
+
+		Promise(Promise&&) noexcept = default;
+		Promise& operator=(Promise&& other) noexcept
+		{
+			if (this != &other)
+			{
+				abandon();
+				state_ = std::move(other.state_);
+			}
+
+			return *this;
+		}
+
+		Promise(const Promise&) = delete;
+		Promise& operator=(const Promise&) = delete;
+
+		virtual ~Promise(void) { abandon(); }
+
+		auto get_future(void) -> Future<T> { return Future<T>(state_); }
+
+		template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>> auto set_value(typename SharedState<U>::Storage value) -> bool
+		{
+			if (state_ == nullptr)
+			{
+				return false;
+			}
+
+			return state_->set_value(std::move(value));
+		}
+
+		template <typename U = T, typename = std::enable_if_t<std::is_void_v<U>>> auto set_value(void) -> bool
+		{
+			if (state_ == nullptr)
+			{
+				return false;
+			}
+
+			return state_->set_value(true);
+		}
+
+		auto set_exception(std::exception_ptr exception) -> bool
+		{
+			if (state_ == nullptr)
+			{
+				return false;
+			}
+
+			return state_->set_exception(exception);
+		}
+
+	private:
+		auto abandon(void) -> void
+		{
+			if (state_ == nullptr)
+			{
+				return;
+			}
+
+			state_->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+			state_.reset();
+		}
+
+	private:
+		std::shared_ptr<SharedState<T>> state_;
+	};
+
+	template <typename T> auto when_all(std::vector<Future<T>> futures) -> Future<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>>
+	{
+		using Result = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+		struct Context
+		{
+			Promise<Result> promise;
+			std::atomic<size_t> remaining;
+			std::vector<std::shared_ptr<SharedState<T>>> states;
+		};
+
+		auto context = std::make_shared<Context>();
+		auto result = context->promise.get_future();
+
+		context->remaining.store(futures.size());
+		for (auto& future : futures)
+		{
+			if (!future.valid())
+			{
+				return Future<Result>::exceptional(std::make_exception_ptr(std::future_error(std::future_errc::no_state)));
+			}
+
+			context->states.push_back(future.state());
+		}
+
+		if (futures.empty())
+		{
+			if constexpr (std::is_void_v<T>)
+			{
+				context->promise.set_value();
+			}
+			else
+			{
+				context->promise.set_value(Result());
+			}
+
+			return result;
+		}
+
+		for (auto& state : context->states)
+		{
+			state->on_ready(
+				[context, state]()
+				{
+					auto exception = state->exception();
+					if (exception != nullptr)
+					{
+						context->promise.set_exception(exception);
+					}
+
+					if (context->remaining.fetch_sub(1) != 1 || exception != nullptr)
+					{
+						return;
+					}
+
+					try
+					{
+						if constexpr (std::is_void_v<T>)
+						{
+							context->promise.set_value();
+						}
+						else
+						{
+							Result values;
+							values.reserve(context->states.size());
+							for (auto& target : context->states)
+							{
+								values.push_back(target->take());
+							}
+
+							context->promise.set_value(std::move(values));
+						}
+					}
+					catch (...)
+					{
+						context->promise.set_exception(std::current_exception());
+					}
+				});
+		}
+
+		return result;
+	}
+
+	template <typename T> auto when_any(const std::vector<Future<T>>& futures) -> Future<size_t>
+	{
+		if (futures.empty())
+		{
+			return Future<size_t>::exceptional(std::make_exception_ptr(std::invalid_argument("cannot wait for any of empty futures")));
+		}
+
+		auto promise = std::make_shared<Promise<size_t>>();
+		auto result = promise->get_future();
+
+		for (size_t index = 0; index < futures.size(); ++index)
+		{
+			auto state = futures[index].state();
+			if (state == nullptr)
+			{
+				continue;
+			}
+
+			state->on_ready([promise, index]() { promise->set_value(index); });
+		}
+
+		return result;
+	}
+} // namespace Thread
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Thread
+{
+	enum class GraphFailurePolicies : uint8_t { CancelDependents, CancelAll, Continue };
+}
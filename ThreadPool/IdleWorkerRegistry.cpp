@@ -0,0 +1,101 @@
+#include "IdleWorkerRegistry.h"
+
+#include "ThreadWorker.h"
+
+#include <algorithm>
+
+namespace Thread
+{
+	IdleWorkerRegistry::IdleWorkerRegistry(void) : wakeups_(0), successful_pops_(0), empty_pops_(0) {}
+
+	IdleWorkerRegistry::~IdleWorkerRegistry(void)
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		for (auto& workers : parked_workers_)
+		{
+			workers.clear();
+		}
+	}
+
+	auto IdleWorkerRegistry::park(std::shared_ptr<ThreadWorker> worker, const std::vector<JobPriorities>& priorities) -> void
+	{
+		if (worker == nullptr)
+		{
+			return;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		remove(worker);
+
+		for (const auto& priority : priorities)
+		{
+			parked_workers_[static_cast<size_t>(priority)].push_back(worker);
+		}
+	}
+
+	auto IdleWorkerRegistry::unpark(std::shared_ptr<ThreadWorker> worker) -> void
+	{
+		if (worker == nullptr)
+		{
+			return;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		remove(worker);
+	}
+
+	auto IdleWorkerRegistry::notify(const JobPriorities& priority, const size_t& count) -> size_t
+	{
+		std::vector<std::shared_ptr<ThreadWorker>> targets;
+
+		{
+			std::scoped_lock<std::mutex> lock(mutex_);
+
+			auto& workers = parked_workers_[static_cast<size_t>(priority)];
+			while (!workers.empty() && targets.size() < count)
+			{
+				auto worker = workers.back();
+				remove(worker);
+
+				targets.push_back(worker);
+			}
+		}
+
+		for (auto& worker : targets)
+		{
+			worker->notify_one(priority);
+		}
+
+		wakeups_.fetch_add(targets.size(), std::memory_order_relaxed);
+
+		return targets.size();
+	}
+
+	auto IdleWorkerRegistry::record_pop(const bool& succeeded) -> void
+	{
+		if (succeeded)
+		{
+			successful_pops_.fetch_add(1, std::memory_order_relaxed);
+
+			return;
+		}
+
+		empty_pops_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto IdleWorkerRegistry::counters(void) -> WakeupCounters
+	{
+		return { wakeups_.load(std::memory_order_relaxed), successful_pops_.load(std::memory_order_relaxed), empty_pops_.load(std::memory_order_relaxed) };
+	}
+
+	auto IdleWorkerRegistry::remove(const std::shared_ptr<ThreadWorker>& worker) -> void
+	{
+		for (auto& workers : parked_workers_)
+		{
+			workers.erase(std::remove(workers.begin(), workers.end(), worker), workers.end());
+		}
+	}
+} // namespace Thread
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "JobPriorities.h"
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Thread
+{
+	class ThreadWorker;
+
+	struct WakeupCounters
+	{
+		uint64_t wakeups;
+		uint64_t successful_pops;
+		uint64_t empty_pops;
+	};
+
+	class IdleWorkerRegistry
+	{
+	public:
+		IdleWorkerRegistry(void);
+		virtual ~IdleWorkerRegistry(void);
+
+		auto park(std::shared_ptr<ThreadWorker> worker, const std::vector<JobPriorities>& priorities) -> void;
+		auto unpark(std::shared_ptr<ThreadWorker> worker) -> void;
+		auto notify(const JobPriorities& priority, const size_t& count) -> size_t;
+
+		auto record_pop(const bool& succeeded) -> void;
+		auto counters(void) -> WakeupCounters;
+
+	private:
+		auto remove(const std::shared_ptr<ThreadWorker>& worker) -> void;
+
+	private:
+		std::mutex mutex_;
+		std::atomic<uint64_t> wakeups_;
+		std::atomic<uint64_t> successful_pops_;
+		std::atomic<uint64_t> empty_pops_;
+		std::array<std::vector<std::shared_ptr<ThreadWorker>>, JOB_PRIORITY_COUNT> parked_workers_;
+	};
+} // namespace Thread
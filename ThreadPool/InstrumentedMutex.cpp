@@ -0,0 +1,60 @@
+#include "InstrumentedMutex.h"
+
+#ifdef USE_LOCK_PROFILING_MODULE
+#include "LockProfiler.h"
+
+namespace Thread
+{
+	InstrumentedMutex::InstrumentedMutex(const std::string& name) : counters_(LockProfiler::handle().counters(name)) {}
+
+	InstrumentedMutex::~InstrumentedMutex(void) {}
+
+	auto InstrumentedMutex::lock(void) -> void
+	{
+		auto requested_time = std::chrono::steady_clock::now();
+		if (mutex_.try_lock())
+		{
+			acquired(false, requested_time);
+
+			return;
+		}
+
+		mutex_.lock();
+		acquired(true, requested_time);
+	}
+
+	auto InstrumentedMutex::try_lock(void) -> bool
+	{
+		auto requested_time = std::chrono::steady_clock::now();
+		if (!mutex_.try_lock())
+		{
+			return false;
+		}
+
+		acquired(false, requested_time);
+
+		return true;
+	}
+
+	auto InstrumentedMutex::unlock(void) -> void
+	{
+		// locked_time_ is only touched by the holder, so it is read before the mutex is handed over
+		counters_->hold.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - locked_time_));
+
+		mutex_.unlock();
+	}
+
+	auto InstrumentedMutex::acquired(const bool& contended, const std::chrono::steady_clock::time_point& requested_time) -> void
+	{
+		locked_time_ = std::chrono::steady_clock::now();
+
+		counters_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+		if (contended)
+		{
+			counters_->contended.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		counters_->wait.record(std::chrono::duration_cast<std::chrono::nanoseconds>(locked_time_ - requested_time));
+	}
+} // namespace Thread
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <condition_variable>
+
+namespace Thread
+{
+#ifdef USE_LOCK_PROFILING_MODULE
+	struct LockCounters;
+
+	// std::mutex replacement that counts acquisitions, contended acquisitions, wait time and hold time under its name.
+	// An uncontended lock costs one try_lock and three clock reads; the counters themselves live in LockProfiler.
+	class InstrumentedMutex
+	{
+	public:
+		InstrumentedMutex(const std::string& name);
+		virtual ~InstrumentedMutex(void);
+
+		InstrumentedMutex(const InstrumentedMutex&) = delete;
+		InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+		auto lock(void) -> void;
+		auto try_lock(void) -> bool;
+		auto unlock(void) -> void;
+
+	private:
+		auto acquired(const bool& contended, const std::chrono::steady_clock::time_point& requested_time) -> void;
+
+	private:
+		std::mutex mutex_;
+		std::shared_ptr<LockCounters> counters_;
+		std::chrono::steady_clock::time_point locked_time_;
+	};
+
+	using InstrumentedLock = std::unique_lock<InstrumentedMutex>;
+	using InstrumentedCondition = std::condition_variable_any;
+#else
+	// without USE_LOCK_PROFILING the name is dropped and this is a plain std::mutex, so the default build pays nothing
+	class InstrumentedMutex : public std::mutex
+	{
+	public:
+		InstrumentedMutex(const std::string&) {}
+	};
+
+	using InstrumentedLock = std::unique_lock<std::mutex>;
+	using InstrumentedCondition = std::condition_variable;
+#endif
+} // namespace Thread
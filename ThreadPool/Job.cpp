@@ -1,8 +1,10 @@
 #include "Job.h"
 
+#include "CancellationToken.h"
 #include "Converter.h"
 #include "File.h"
 #include "Generator.h"
+#include "JobJournal.h"
 #include "JobPool.h"
 #include "Logger.h"
 
@@ -96,11 +98,65 @@ namespace Thread
 
 	auto Job::data(const std::vector<uint8_t>& data_array) -> void { data_ = data_array; }
 
+	auto Job::data(void) const -> const std::vector<uint8_t>& { return data_; }
+
+	auto Job::enqueued_time(const std::chrono::steady_clock::time_point& time) -> void { enqueued_time_ = time; }
+
+	auto Job::enqueued_time(void) const -> std::chrono::steady_clock::time_point { return enqueued_time_; }
+
+	auto Job::cancellation_token(std::shared_ptr<CancellationToken> token) -> void { cancellation_token_ = token; }
+
+	auto Job::cancellation_token(void) const -> std::shared_ptr<CancellationToken> { return cancellation_token_; }
+
+	auto Job::deadline(const std::chrono::steady_clock::time_point& time) -> void { deadline_ = time; }
+
+	auto Job::deadline(void) const -> std::optional<std::chrono::steady_clock::time_point> { return deadline_; }
+
+	auto Job::cancelled(void) const -> bool
+	{
+		if (cancellation_token_ != nullptr && cancellation_token_->cancelled())
+		{
+			return true;
+		}
+
+		return deadline_ != std::nullopt && std::chrono::steady_clock::now() >= deadline_.value();
+	}
+
+	auto Job::coalescing_key(const std::string& key) -> void { coalescing_key_ = key; }
+
+	auto Job::coalescing_key(void) const -> const std::string { return coalescing_key_; }
+
+	auto Job::coalesce(std::shared_ptr<Job> incoming) -> std::shared_ptr<Job>
+	{
+		// the newest job replaces the queued one by default; a derived job can fold incoming into itself and return get_ptr() instead
+		destroy();
+
+		return incoming;
+	}
+
+	auto Job::tenant(const std::string& tenant_id) -> void { tenant_ = tenant_id; }
+
+	auto Job::tenant(void) const -> const std::string { return tenant_; }
+
 	auto Job::work(void) -> std::tuple<bool, std::optional<std::string>>
 	{
 		auto start_time_flag = Logger::handle().chrono_start();
 
-		load();
+		if (cancelled())
+		{
+			destroy();
+
+			return { false, fmt::format("cancelled work on {} [ {} ]", title_, priority_string(priority_)) };
+		}
+
+		// a payload that cannot be restored must not reach a callback that indexes into it
+		auto [loaded, load_error] = load();
+		if (!loaded)
+		{
+			destroy();
+
+			return { false, load_error };
+		}
 
 		std::tuple<bool, std::optional<std::string>> result;
 		if (callback1_)
@@ -184,6 +240,44 @@ namespace Thread
 		return result;
 	}
 
+	auto Job::reset(const JobPriorities& priority, const std::vector<uint8_t>& data, const std::string& title, const bool& use_time_stamp) -> void
+	{
+		title_ = title;
+		priority_ = priority;
+		data_.assign(data.begin(), data.end());
+		use_time_stamp_ = use_time_stamp;
+	}
+
+	auto Job::reset(const JobPriorities& priority,
+					const std::vector<uint8_t>& data,
+					const std::function<std::tuple<bool, std::optional<std::string>>(const std::vector<uint8_t>&)>& callback,
+					const std::string& title,
+					const bool& use_time_stamp) -> void
+	{
+		reset(priority, data, title, use_time_stamp);
+
+		callback4_ = callback;
+	}
+
+	auto Job::recycle(void) -> void
+	{
+		destroy();
+
+		data_.clear();
+		job_pool_.reset();
+		cancellation_token_.reset();
+		journal_.reset();
+		journal_id_ = std::nullopt;
+		deadline_ = std::nullopt;
+		coalescing_key_.clear();
+		tenant_.clear();
+
+		callback1_ = nullptr;
+		callback2_ = nullptr;
+		callback3_ = nullptr;
+		callback4_ = nullptr;
+	}
+
 	auto Job::destroy(void) -> void
 	{
 		if (temporary_file_.empty())
@@ -208,11 +302,21 @@ namespace Thread
 		return boost::json::serialize(message);
 	}
 
-	auto Job::save(const std::string& folder_name) -> void
+	auto Job::save(const std::string& folder_name) -> std::tuple<bool, std::optional<std::string>>
 	{
+		// a job spilled by backpressure is read back first, so saving it again moves the payload into the requested folder
+		if (data_.empty() && !temporary_file_.empty())
+		{
+			auto [restored, restore_error] = restore();
+			if (!restored)
+			{
+				return { false, restore_error };
+			}
+		}
+
 		if (data_.empty())
 		{
-			return;
+			return { false, fmt::format("cannot save {} without data", title_) };
 		}
 
 		std::string priority = "";
@@ -231,25 +335,96 @@ namespace Thread
 			priority = "top";
 			break;
 		default:
-			return;
+			return { false, fmt::format("cannot save {} with {} priority", title_, priority_string(priority_)) };
+		}
+
+		auto folder = std::filesystem::temp_directory_path() / folder_name;
+
+		std::error_code ec;
+		std::filesystem::create_directories(folder, ec);
+		if (ec)
+		{
+			return { false, fmt::format("cannot create a folder : {} => {}", folder.string(), ec.message()) };
 		}
 
 		auto temp_filename = fmt::format("{}.{}", Generator::guid(), priority);
-		temporary_file_ = (std::filesystem::temp_directory_path() / folder_name / temp_filename).string();
+		temporary_file_ = (folder / temp_filename).string();
 
 		File target;
-		target.open(temporary_file_, std::ios::out | std::ios::binary | std::ios::trunc);
-		target.write_bytes(data_);
+		auto [opened, open_error] = target.open(temporary_file_, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!opened)
+		{
+			temporary_file_.clear();
+
+			return { false, open_error };
+		}
+
+		auto [written, write_error] = target.write_bytes(data_);
 		target.close();
+		if (!written)
+		{
+			destroy();
+
+			return { false, write_error };
+		}
+
+		data_.clear();
+
+		return { true, std::nullopt };
+	}
+
+	auto Job::journal(std::shared_ptr<JobJournal> journal, const std::optional<uint64_t>& id) -> void
+	{
+		journal_ = journal;
+		journal_id_ = id;
+	}
+
+	auto Job::journal_id(void) const -> std::optional<uint64_t> { return journal_id_; }
+
+	auto Job::offload(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (journal_ == nullptr || journal_id_ == std::nullopt)
+		{
+			return { false, fmt::format("cannot offload {} without a journal record", title_) };
+		}
 
 		data_.clear();
+		data_.shrink_to_fit();
+
+		return { true, std::nullopt };
+	}
+
+	auto Job::restore(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		auto [loaded, load_error] = load();
+		if (!loaded)
+		{
+			return { false, load_error };
+		}
+
+		destroy();
+
+		return { true, std::nullopt };
 	}
 
-	auto Job::load(void) -> void
+	auto Job::load(void) -> std::tuple<bool, std::optional<std::string>>
 	{
+		if (temporary_file_.empty() && data_.empty() && journal_ != nullptr && journal_id_ != std::nullopt)
+		{
+			auto [journal_data, journal_error] = journal_->read(journal_id_.value());
+			if (journal_data == std::nullopt)
+			{
+				return { false, fmt::format("cannot load {} from journal : {}", title_, journal_error.value_or("unknown error")) };
+			}
+
+			data_ = journal_data.value();
+
+			return { true, std::nullopt };
+		}
+
 		if (temporary_file_.empty())
 		{
-			return;
+			return { true, std::nullopt };
 		}
 
 		File source;
@@ -260,7 +435,8 @@ namespace Thread
 		if (source_data == std::nullopt)
 		{
 			data_.clear();
-			return;
+
+			return { false, fmt::format("cannot load {} from {} : {}", title_, temporary_file_, message.value_or("unknown error")) };
 		}
 
 		data_ = source_data.value();
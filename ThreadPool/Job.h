@@ -3,6 +3,7 @@
 #include "JobPriorities.h"
 
 #include <tuple>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -12,6 +13,8 @@
 namespace Thread
 {
 	class JobPool;
+	class CancellationToken;
+	class JobJournal;
 	class Job : public std::enable_shared_from_this<Job>
 	{
 	public:
@@ -47,16 +50,54 @@ namespace Thread
 		auto title(void) -> const std::string;
 
 		auto data(const std::vector<uint8_t>& data_array) -> void;
+		auto data(void) const -> const std::vector<uint8_t>&;
+
+		auto enqueued_time(const std::chrono::steady_clock::time_point& time) -> void;
+		auto enqueued_time(void) const -> std::chrono::steady_clock::time_point;
+
+		auto cancellation_token(std::shared_ptr<CancellationToken> token) -> void;
+		auto cancellation_token(void) const -> std::shared_ptr<CancellationToken>;
+
+		// a deadline must be set before the job is pushed; once it passes, the job counts as cancelled
+		auto deadline(const std::chrono::steady_clock::time_point& time) -> void;
+		auto deadline(void) const -> std::optional<std::chrono::steady_clock::time_point>;
+
+		auto cancelled(void) const -> bool;
+
+		// jobs of one priority sharing a non-empty key are coalesced by JobPool::push while the first one is still queued
+		auto coalescing_key(const std::string& key) -> void;
+		auto coalescing_key(void) const -> const std::string;
+
+		virtual auto coalesce(std::shared_ptr<Job> incoming) -> std::shared_ptr<Job>;
+
+		// an empty or unregistered tenant shares the default tenant of the pool
+		auto tenant(const std::string& tenant_id) -> void;
+		auto tenant(void) const -> const std::string;
 
 		auto work(void) -> std::tuple<bool, std::optional<std::string>>;
 
+		auto reset(const JobPriorities& priority, const std::vector<uint8_t>& data, const std::string& title = "Job", const bool& use_time_stamp = true) -> void;
+		auto reset(const JobPriorities& priority,
+				   const std::vector<uint8_t>& data,
+				   const std::function<std::tuple<bool, std::optional<std::string>>(const std::vector<uint8_t>&)>& callback,
+				   const std::string& title = "Job",
+				   const bool& use_time_stamp = true) -> void;
+		virtual auto recycle(void) -> void;
+
 		auto destroy(void) -> void;
 
 		auto to_json(void) -> const std::string;
 
+		auto save(const std::string& folder_name) -> std::tuple<bool, std::optional<std::string>>;
+
+		// a journaled job can drop its payload from memory and read it back from the journal when it runs
+		auto journal(std::shared_ptr<JobJournal> journal, const std::optional<uint64_t>& id) -> void;
+		auto journal_id(void) const -> std::optional<uint64_t>;
+		auto offload(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto restore(void) -> std::tuple<bool, std::optional<std::string>>;
+
 	protected:
-		auto save(const std::string& folder_name) -> void;
-		auto load(void) -> void;
+		auto load(void) -> std::tuple<bool, std::optional<std::string>>;
 
 		auto get_data(void) -> std::vector<uint8_t>&;
 		auto get_data(void) const -> const std::vector<uint8_t>&;
@@ -72,8 +113,15 @@ namespace Thread
 		bool use_time_stamp_;
 		std::vector<uint8_t> data_;
 		std::string temporary_file_;
+		std::shared_ptr<JobJournal> journal_;
+		std::optional<uint64_t> journal_id_;
 		JobPriorities priority_;
 		std::weak_ptr<JobPool> job_pool_;
+		std::chrono::steady_clock::time_point enqueued_time_;
+		std::shared_ptr<CancellationToken> cancellation_token_;
+		std::optional<std::chrono::steady_clock::time_point> deadline_;
+		std::string coalescing_key_;
+		std::string tenant_;
 		std::function<std::tuple<bool, std::optional<std::string>>(void)> callback1_;
 		std::function<std::tuple<bool, std::optional<std::string>>(const bool&)> callback2_;
 		std::function<std::tuple<bool, std::optional<std::string>>(const int&)> callback3_;
@@ -0,0 +1,395 @@
+#include "JobGraph.h"
+
+#include "Job.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+
+#include "fmt/format.h"
+#include "fmt/xchar.h"
+
+#include <utility>
+#include <stdexcept>
+
+using namespace Utilities;
+
+namespace Thread
+{
+	namespace
+	{
+		// the node whose dispatch call is on this thread's stack, since that caller handles a rejected push itself
+		thread_local std::pair<const JobGraph*, size_t> dispatching_ = { nullptr, 0 };
+	} // namespace
+
+	// Node task that owns the node's settlement; if the pool drops it unrun, the node is cancelled so the graph still finishes
+	class JobGraph::NodeTask
+	{
+	public:
+		NodeTask(std::shared_ptr<JobGraph> graph, const size_t& node) : graph_(std::move(graph)), node_(node) {}
+
+		NodeTask(NodeTask&& other) noexcept : graph_(std::move(other.graph_)), node_(other.node_) {}
+
+		NodeTask(const NodeTask&) = delete;
+		NodeTask& operator=(const NodeTask&) = delete;
+		NodeTask& operator=(NodeTask&&) = delete;
+
+		~NodeTask(void)
+		{
+			if (graph_ == nullptr || dispatching_ == std::make_pair(static_cast<const JobGraph*>(graph_.get()), node_))
+			{
+				return;
+			}
+
+			Logger::handle().write(LogTypes::Sequence, fmt::format("discarded {} on {}", graph_->nodes_[node_].title, graph_->title_));
+
+			graph_->cancelled_.fetch_add(1);
+			graph_->propagate(node_, true);
+		}
+
+		auto operator()(void) -> void { std::exchange(graph_, nullptr)->execute(node_); }
+
+	private:
+		std::shared_ptr<JobGraph> graph_;
+		size_t node_;
+	};
+
+	JobGraph::JobGraph(const std::string& title, const GraphFailurePolicies& policy)
+		: title_(title)
+		, failure_policy_(policy)
+		, running_(false)
+		, aborted_(false)
+		, pending_(0)
+		, completed_(0)
+		, failed_(0)
+		, cancelled_(0)
+		, error_captured_(false)
+		, error_message_(std::nullopt)
+		, remaining_(nullptr)
+		, skipped_(nullptr)
+		, promise_(nullptr)
+	{
+	}
+
+	JobGraph::~JobGraph(void) {}
+
+	auto JobGraph::get_ptr(void) -> std::shared_ptr<JobGraph> { return shared_from_this(); }
+
+	auto JobGraph::add(const JobPriorities& priority, const std::function<std::tuple<bool, std::optional<std::string>>(void)>& callback, const std::string& title)
+		-> std::tuple<std::optional<size_t>, std::optional<std::string>>
+	{
+		if (running_.load())
+		{
+			return { std::nullopt, fmt::format("cannot change {} while it is running", title_) };
+		}
+
+		nodes_.push_back({ priority, title, callback, {}, 0 });
+
+		return { nodes_.size() - 1, std::nullopt };
+	}
+
+	auto JobGraph::add(std::shared_ptr<Job> job) -> std::tuple<std::optional<size_t>, std::optional<std::string>>
+	{
+		if (job == nullptr)
+		{
+			return add(
+				JobPriorities::Normal, []() -> std::tuple<bool, std::optional<std::string>> { return { false, "cannot run a null job" }; }, "NullJob");
+		}
+
+		return add(job->priority(), [job]() { return job->work(); }, job->title());
+	}
+
+	auto JobGraph::depends(const size_t& node, const size_t& predecessor) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (running_.load())
+		{
+			return { false, fmt::format("cannot change {} while it is running", title_) };
+		}
+
+		if (node >= nodes_.size() || predecessor >= nodes_.size())
+		{
+			return { false, fmt::format("cannot add an edge {} -> {} on {} : out of range [{}]", predecessor, node, title_, nodes_.size()) };
+		}
+
+		if (node == predecessor)
+		{
+			return { false, fmt::format("cannot add a self edge on {} : {}", title_, node) };
+		}
+
+		nodes_[predecessor].successors.push_back(node);
+		nodes_[node].predecessor_count++;
+
+		return { true, std::nullopt };
+	}
+
+	auto JobGraph::failure_policy(const GraphFailurePolicies& policy) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (running_.load())
+		{
+			return { false, fmt::format("cannot change {} while it is running", title_) };
+		}
+
+		failure_policy_ = policy;
+
+		return { true, std::nullopt };
+	}
+
+	auto JobGraph::failure_policy(void) const -> GraphFailurePolicies { return failure_policy_; }
+
+	auto JobGraph::size(void) const -> size_t { return nodes_.size(); }
+
+	auto JobGraph::running(void) const -> bool { return running_.load(); }
+
+	auto JobGraph::submit(std::shared_ptr<ThreadPool> pool) -> Future<GraphResults>
+	{
+		if (pool == nullptr)
+		{
+			return Future<GraphResults>::exceptional(std::make_exception_ptr(std::invalid_argument(fmt::format("cannot submit {} on null ThreadPool", title_))));
+		}
+
+		if (weak_from_this().expired())
+		{
+			return Future<GraphResults>::exceptional(
+				std::make_exception_ptr(std::logic_error(fmt::format("cannot submit {} which is not owned by std::shared_ptr", title_))));
+		}
+
+		if (running_.exchange(true))
+		{
+			return Future<GraphResults>::exceptional(std::make_exception_ptr(std::logic_error(fmt::format("cannot submit {} while it is running", title_))));
+		}
+
+		auto [validated, message] = validate();
+		if (!validated)
+		{
+			running_.store(false);
+
+			return Future<GraphResults>::exceptional(std::make_exception_ptr(std::logic_error(message.value())));
+		}
+
+		Promise<GraphResults> promise;
+		auto future = promise.get_future();
+
+		if (nodes_.empty())
+		{
+			running_.store(false);
+			promise.set_value({ 0, 0, 0, std::nullopt });
+
+			return future;
+		}
+
+		aborted_.store(false);
+		completed_.store(0);
+		failed_.store(0);
+		cancelled_.store(0);
+		error_captured_.store(false);
+		error_message_ = std::nullopt;
+
+		remaining_ = std::make_unique<std::atomic<size_t>[]>(nodes_.size());
+		skipped_ = std::make_unique<std::atomic<bool>[]>(nodes_.size());
+		for (size_t index = 0; index < nodes_.size(); ++index)
+		{
+			remaining_[index].store(nodes_[index].predecessor_count);
+			skipped_[index].store(false);
+		}
+
+		thread_pool_ = pool;
+		promise_ = std::make_unique<Promise<GraphResults>>(std::move(promise));
+		pending_.store(nodes_.size());
+
+		Logger::handle().write(LogTypes::Sequence, fmt::format("submitted {} with {} nodes", title_, nodes_.size()));
+
+		std::vector<size_t> roots;
+		for (size_t index = 0; index < nodes_.size(); ++index)
+		{
+			if (nodes_[index].predecessor_count == 0)
+			{
+				roots.push_back(index);
+			}
+		}
+
+		for (const auto& root : roots)
+		{
+			if (!dispatch(root))
+			{
+				propagate(root, true);
+			}
+		}
+
+		return future;
+	}
+
+	auto JobGraph::validate(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		std::vector<size_t> remaining(nodes_.size());
+		std::vector<size_t> ready;
+		for (size_t index = 0; index < nodes_.size(); ++index)
+		{
+			remaining[index] = nodes_[index].predecessor_count;
+			if (remaining[index] == 0)
+			{
+				ready.push_back(index);
+			}
+		}
+
+		size_t visited = 0;
+		while (!ready.empty())
+		{
+			auto current = ready.back();
+			ready.pop_back();
+			visited++;
+
+			for (const auto& successor : nodes_[current].successors)
+			{
+				if (--remaining[successor] == 0)
+				{
+					ready.push_back(successor);
+				}
+			}
+		}
+
+		if (visited != nodes_.size())
+		{
+			return { false, fmt::format("cannot submit {} : {} nodes are on a cycle", title_, nodes_.size() - visited) };
+		}
+
+		return { true, std::nullopt };
+	}
+
+	auto JobGraph::dispatch(const size_t& node) -> bool
+	{
+		auto pool = thread_pool_.lock();
+		if (pool == nullptr)
+		{
+			record_failure(node, "thread pool has been released");
+
+			return false;
+		}
+
+		auto previous = std::exchange(dispatching_, { this, node });
+		auto [pushed, message] = pool->push(nodes_[node].priority, Task(NodeTask(get_ptr(), node)));
+		dispatching_ = previous;
+		if (!pushed)
+		{
+			record_failure(node, message.value_or("cannot push a node"));
+
+			return false;
+		}
+
+		return true;
+	}
+
+	auto JobGraph::execute(const size_t& node) -> void
+	{
+		if (aborted_.load())
+		{
+			cancelled_.fetch_add(1);
+			propagate(node, true);
+
+			return;
+		}
+
+		auto& target = nodes_[node];
+
+		bool succeeded = false;
+		std::optional<std::string> error_message = std::nullopt;
+		try
+		{
+			if (target.callback)
+			{
+				std::tie(succeeded, error_message) = target.callback();
+			}
+			else
+			{
+				error_message = "cannot run a node without callback";
+			}
+		}
+		catch (const std::exception& message)
+		{
+			error_message = message.what();
+		}
+		catch (...)
+		{
+			error_message = "unexpected error";
+		}
+
+		if (!succeeded)
+		{
+			record_failure(node, error_message.value_or("unknown error"));
+			propagate(node, true);
+
+			return;
+		}
+
+		completed_.fetch_add(1);
+		propagate(node, false);
+	}
+
+	auto JobGraph::propagate(const size_t& node, const bool& failed) -> void
+	{
+		std::vector<std::pair<size_t, bool>> targets{ { node, failed } };
+		while (!targets.empty())
+		{
+			auto [current, current_failed] = targets.back();
+			targets.pop_back();
+
+			for (const auto& successor : nodes_[current].successors)
+			{
+				if (current_failed && failure_policy_ != GraphFailurePolicies::Continue)
+				{
+					skipped_[successor].store(true);
+				}
+
+				if (remaining_[successor].fetch_sub(1) != 1)
+				{
+					continue;
+				}
+
+				if (skipped_[successor].load() || aborted_.load())
+				{
+					cancelled_.fetch_add(1);
+					targets.push_back({ successor, true });
+
+					continue;
+				}
+
+				if (!dispatch(successor))
+				{
+					targets.push_back({ successor, true });
+				}
+			}
+
+			if (pending_.fetch_sub(1) == 1)
+			{
+				finish();
+			}
+		}
+	}
+
+	auto JobGraph::record_failure(const size_t& node, const std::string& error_message) -> void
+	{
+		failed_.fetch_add(1);
+
+		if (!error_captured_.exchange(true))
+		{
+			error_message_ = fmt::format("{} on {} : {}", nodes_[node].title, title_, error_message);
+		}
+
+		if (failure_policy_ == GraphFailurePolicies::CancelAll)
+		{
+			aborted_.store(true);
+		}
+
+		Logger::handle().write(LogTypes::Error, fmt::format("cannot complete {} [ {} ] on {} : {}", nodes_[node].title, priority_string(nodes_[node].priority), title_,
+															error_message));
+	}
+
+	auto JobGraph::finish(void) -> void
+	{
+		GraphResults results{ completed_.load(), failed_.load(), cancelled_.load(), error_message_ };
+		auto promise = std::move(promise_);
+
+		Logger::handle().write(LogTypes::Sequence, fmt::format("completed {} : completed {}, failed {}, cancelled {}", title_, results.completed, results.failed,
+															   results.cancelled));
+
+		running_.store(false);
+		promise->set_value(std::move(results));
+	}
+} // namespace Thread
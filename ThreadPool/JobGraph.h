@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Future.h"
+#include "JobPriorities.h"
+#include "GraphFailurePolicies.h"
+
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+
+namespace Thread
+{
+	class Job;
+	class ThreadPool;
+
+	struct GraphResults
+	{
+		size_t completed;
+		size_t failed;
+		size_t cancelled;
+		std::optional<std::string> error_message;
+	};
+
+	// Nodes and edges are declared up front, then submit() releases every root to its priority lane.
+	// A node is pushed when its last predecessor settles; the graph never takes a lock while running.
+	class JobGraph : public std::enable_shared_from_this<JobGraph>
+	{
+	public:
+		JobGraph(const std::string& title = "JobGraph", const GraphFailurePolicies& policy = GraphFailurePolicies::CancelDependents);
+		virtual ~JobGraph(void);
+
+		auto get_ptr(void) -> std::shared_ptr<JobGraph>;
+
+		auto add(const JobPriorities& priority, const std::function<std::tuple<bool, std::optional<std::string>>(void)>& callback, const std::string& title = "Node")
+			-> std::tuple<std::optional<size_t>, std::optional<std::string>>;
+		auto add(std::shared_ptr<Job> job) -> std::tuple<std::optional<size_t>, std::optional<std::string>>;
+		auto depends(const size_t& node, const size_t& predecessor) -> std::tuple<bool, std::optional<std::string>>;
+
+		auto failure_policy(const GraphFailurePolicies& policy) -> std::tuple<bool, std::optional<std::string>>;
+		auto failure_policy(void) const -> GraphFailurePolicies;
+
+		auto size(void) const -> size_t;
+		auto running(void) const -> bool;
+
+		auto submit(std::shared_ptr<ThreadPool> pool) -> Future<GraphResults>;
+
+	private:
+		class NodeTask;
+
+		auto validate(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto dispatch(const size_t& node) -> bool;
+		auto execute(const size_t& node) -> void;
+		auto propagate(const size_t& node, const bool& failed) -> void;
+		auto record_failure(const size_t& node, const std::string& error_message) -> void;
+		auto finish(void) -> void;
+
+	private:
+		struct Node
+		{
+			JobPriorities priority;
+			std::string title;
+			std::function<std::tuple<bool, std::optional<std::string>>(void)> callback;
+			std::vector<size_t> successors;
+			size_t predecessor_count;
+		};
+
+		std::string title_;
+		GraphFailurePolicies failure_policy_;
+		std::vector<Node> nodes_;
+
+		std::atomic<bool> running_;
+		std::atomic<bool> aborted_;
+		std::atomic<size_t> pending_;
+		std::atomic<size_t> completed_;
+		std::atomic<size_t> failed_;
+		std::atomic<size_t> cancelled_;
+		std::atomic<bool> error_captured_;
+		std::optional<std::string> error_message_;
+
+		std::unique_ptr<std::atomic<size_t>[]> remaining_;
+		std::unique_ptr<std::atomic<bool>[]> skipped_;
+
+		std::weak_ptr<ThreadPool> thread_pool_;
+		std::unique_ptr<Promise<GraphResults>> promise_;
+	};
+} // namespace Thread
@@ -0,0 +1,575 @@
+#include "JobJournal.h"
+
+#include "Logger.h"
+
+#include "fmt/format.h"
+#include "fmt/xchar.h"
+
+#include <array>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+using namespace Utilities;
+
+namespace Thread
+{
+	namespace
+	{
+		// magic, type, priority, reserved, id, length and crc in native byte order
+		constexpr uint32_t JOURNAL_MAGIC = 0x4A4F424A;
+		constexpr size_t JOURNAL_HEADER_SIZE = 24;
+		constexpr size_t JOURNAL_CRC_OFFSET = 20;
+		constexpr uint8_t JOURNAL_ENQUEUE = 1;
+		constexpr uint8_t JOURNAL_COMPLETE = 2;
+		constexpr const char* JOURNAL_EXTENSION = ".journal";
+
+		auto crc_table(void) -> const std::array<uint32_t, 256>&
+		{
+			static const std::array<uint32_t, 256> table = []()
+			{
+				std::array<uint32_t, 256> result{};
+				for (uint32_t index = 0; index < 256; ++index)
+				{
+					uint32_t value = index;
+					for (int bit = 0; bit < 8; ++bit)
+					{
+						value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+					}
+					result[index] = value;
+				}
+				return result;
+			}();
+
+			return table;
+		}
+
+		auto crc32(uint32_t crc, const uint8_t* data, const size_t& length) -> uint32_t
+		{
+			auto& table = crc_table();
+
+			crc = ~crc;
+			for (size_t index = 0; index < length; ++index)
+			{
+				crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+			}
+
+			return ~crc;
+		}
+
+		template <typename Value> auto put(uint8_t* target, const size_t& offset, const Value& value) -> void { std::memcpy(target + offset, &value, sizeof(Value)); }
+
+		template <typename Value> auto get(const uint8_t* source, const size_t& offset) -> Value
+		{
+			Value value;
+			std::memcpy(&value, source + offset, sizeof(Value));
+
+			return value;
+		}
+	} // namespace
+
+	JobJournal::JobJournal(const std::string& folder, const size_t& segment_size)
+		: folder_(folder), segment_size_(segment_size), opened_(false), next_id_(1), current_segment_(0), current_size_(0)
+	{
+	}
+
+	JobJournal::~JobJournal(void) { close(); }
+
+	auto JobJournal::open(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		if (opened_)
+		{
+			return { true, std::nullopt };
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(folder_, ec);
+		if (ec)
+		{
+			return { false, fmt::format("cannot create a folder : {} => {}", folder_, ec.message()) };
+		}
+
+		std::vector<uint64_t> found;
+		for (std::filesystem::directory_iterator iterator(folder_, ec), end; !ec && iterator != end; iterator.increment(ec))
+		{
+			if (!iterator->is_regular_file() || iterator->path().extension() != JOURNAL_EXTENSION)
+			{
+				continue;
+			}
+
+			try
+			{
+				found.push_back(std::stoull(iterator->path().stem().string()));
+			}
+			catch (...)
+			{
+				continue;
+			}
+		}
+		std::sort(found.begin(), found.end());
+
+		segments_.clear();
+		locations_.clear();
+
+		for (const auto& segment : found)
+		{
+			segments_.insert({ segment, { 0, 0 } });
+
+			auto [scanned, scan_error] = scan(segment,
+											  [this, &segment](const Record& record)
+											  {
+												  next_id_ = std::max(next_id_, record.id + 1);
+
+												  if (record.type == JOURNAL_COMPLETE)
+												  {
+													  auto iter = locations_.find(record.id);
+													  if (iter != locations_.end())
+													  {
+														  segments_[iter->second.segment].live--;
+														  locations_.erase(iter);
+													  }
+
+													  return;
+												  }
+
+												  // a record seen twice was relocated by a compaction that did not get to remove its old segment
+												  auto iter = locations_.find(record.id);
+												  if (iter != locations_.end())
+												  {
+													  segments_[iter->second.segment].live--;
+												  }
+
+												  locations_[record.id] = { segment, record.offset };
+												  segments_[segment].total++;
+												  segments_[segment].live++;
+											  });
+			if (!scanned)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot replay journal segment {} : {}", segment_path(segment), scan_error.value_or("unknown error")));
+			}
+		}
+
+		// appends always start on a fresh segment, so nothing is ever written behind a torn tail
+		current_segment_ = found.empty() ? 1 : found.back() + 1;
+		current_size_ = 0;
+		segments_.insert({ current_segment_, { 0, 0 } });
+
+		auto [writable, open_error] = writer_.open(segment_path(current_segment_), std::ios::out | std::ios::binary | std::ios::app);
+		if (!writable)
+		{
+			return { false, open_error };
+		}
+
+		opened_ = true;
+
+		Logger::handle().write(LogTypes::Information,
+							   fmt::format("opened job journal {} with {} segments and {} live records", folder_, found.size(), locations_.size()));
+
+		compact_segments();
+
+		return { true, std::nullopt };
+	}
+
+	auto JobJournal::close(void) -> void
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		if (!opened_)
+		{
+			return;
+		}
+
+		writer_.close();
+		opened_ = false;
+	}
+
+	auto JobJournal::append(const JobPriorities& priority, const std::vector<uint8_t>& data) -> std::tuple<std::optional<uint64_t>, std::optional<std::string>>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		if (!opened_)
+		{
+			return { std::nullopt, fmt::format("cannot append to closed journal : {}", folder_) };
+		}
+
+		auto id = next_id_++;
+
+		auto [offset, write_error] = write(JOURNAL_ENQUEUE, priority, id, data);
+		if (offset == std::nullopt)
+		{
+			return { std::nullopt, write_error };
+		}
+
+		locations_[id] = { current_segment_, offset.value() };
+		segments_[current_segment_].total++;
+		segments_[current_segment_].live++;
+
+		if (current_size_ >= segment_size_)
+		{
+			roll();
+		}
+
+		return { id, std::nullopt };
+	}
+
+	auto JobJournal::complete(const uint64_t& id) -> void
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		if (!opened_)
+		{
+			return;
+		}
+
+		auto iter = locations_.find(id);
+		if (iter == locations_.end())
+		{
+			return;
+		}
+
+		auto [offset, write_error] = write(JOURNAL_COMPLETE, JobPriorities::Normal, id, {});
+		if (offset == std::nullopt)
+		{
+			// the record replays as live and the job runs once more after a crash, which is the safe side
+			Logger::handle().write(LogTypes::Error, fmt::format("cannot journal completion of {} : {}", id, write_error.value_or("unknown error")));
+
+			return;
+		}
+
+		auto segment = iter->second.segment;
+		segments_[segment].live--;
+		locations_.erase(iter);
+
+		if (current_size_ >= segment_size_)
+		{
+			roll();
+
+			return;
+		}
+
+		// the oldest segment just ran empty, so the history behind it can go without waiting for the next roll
+		if (segments_[segment].live == 0 && segment == segments_.begin()->first)
+		{
+			compact_segments();
+		}
+	}
+
+	auto JobJournal::read(const uint64_t& id) -> std::tuple<std::optional<std::vector<uint8_t>>, std::optional<std::string>>
+	{
+		// the lock is held until the payload is in memory, since compaction may relocate the record and remove its segment
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto iter = locations_.find(id);
+		if (iter == locations_.end())
+		{
+			return { std::nullopt, fmt::format("there is no live journal record {}", id) };
+		}
+
+		auto location = iter->second;
+
+		File source;
+		auto [opened, open_error] = source.open(segment_path(location.segment), std::ios::in | std::ios::binary);
+		if (!opened)
+		{
+			return { std::nullopt, open_error };
+		}
+
+		auto [header, header_error] = source.read_bytes(location.offset, JOURNAL_HEADER_SIZE);
+		if (header == std::nullopt || header->size() != JOURNAL_HEADER_SIZE)
+		{
+			return { std::nullopt, fmt::format("cannot read journal record {} : {}", id, header_error.value_or("truncated header")) };
+		}
+
+		auto length = static_cast<size_t>(get<uint32_t>(header->data(), 16));
+		auto [payload, payload_error] = source.read_bytes(location.offset + JOURNAL_HEADER_SIZE, length);
+		source.close();
+
+		if (payload == std::nullopt || payload->size() != length)
+		{
+			return { std::nullopt, fmt::format("cannot read journal record {} : {}", id, payload_error.value_or("truncated payload")) };
+		}
+
+		auto crc = crc32(0, header->data(), JOURNAL_CRC_OFFSET);
+		crc = crc32(crc, payload->data(), payload->size());
+		if (crc != get<uint32_t>(header->data(), JOURNAL_CRC_OFFSET))
+		{
+			return { std::nullopt, fmt::format("cannot read journal record {} : checksum mismatch", id) };
+		}
+
+		return { payload, std::nullopt };
+	}
+
+	auto JobJournal::recover(void) -> std::vector<JournalEntry>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		std::map<uint64_t, JournalEntry> entries;
+		for (const auto& [segment, state] : segments_)
+		{
+			if (state.live == 0)
+			{
+				continue;
+			}
+
+			scan(segment,
+				 [this, &entries, segment = segment](const Record& record)
+				 {
+					 if (record.type != JOURNAL_ENQUEUE)
+					 {
+						 return;
+					 }
+
+					 auto iter = locations_.find(record.id);
+					 if (iter == locations_.end() || iter->second.segment != segment || iter->second.offset != record.offset)
+					 {
+						 return;
+					 }
+
+					 entries[record.id] = { record.id, record.priority, std::vector<uint8_t>(record.data, record.data + record.length) };
+				 });
+		}
+
+		// the records stay live until the caller has pushed the payloads again and completes the old ids, so a crash in between loses nothing
+		std::vector<JournalEntry> result;
+		result.reserve(entries.size());
+		for (auto& [id, entry] : entries)
+		{
+			result.push_back(std::move(entry));
+		}
+
+		Logger::handle().write(LogTypes::Information, fmt::format("recovered {} jobs from journal {}", result.size(), folder_));
+
+		return result;
+	}
+
+	auto JobJournal::compact(void) -> void
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		compact_segments();
+	}
+
+	auto JobJournal::folder(void) const -> const std::string { return folder_; }
+
+	auto JobJournal::live_count(void) -> size_t
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		return locations_.size();
+	}
+
+	auto JobJournal::exists(const std::string& folder) -> bool
+	{
+		std::error_code ec;
+		for (std::filesystem::directory_iterator iterator(folder, ec), end; !ec && iterator != end; iterator.increment(ec))
+		{
+			if (iterator->is_regular_file() && iterator->path().extension() == JOURNAL_EXTENSION)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	auto JobJournal::segment_path(const uint64_t& segment) const -> std::string
+	{
+		return (std::filesystem::path(folder_) / fmt::format("{:010}{}", segment, JOURNAL_EXTENSION)).string();
+	}
+
+	auto JobJournal::scan(const uint64_t& segment, const std::function<void(const Record&)>& handler) -> std::tuple<bool, std::optional<std::string>>
+	{
+		File source;
+		auto [opened, open_error] = source.open(segment_path(segment), std::ios::in | std::ios::binary);
+		if (!opened)
+		{
+			return { false, open_error };
+		}
+
+		auto [content, read_error] = source.read_bytes();
+		source.close();
+
+		if (content == std::nullopt)
+		{
+			return { false, read_error };
+		}
+
+		const auto& bytes = content.value();
+
+		size_t offset = 0;
+		while (offset + JOURNAL_HEADER_SIZE <= bytes.size())
+		{
+			auto header = bytes.data() + offset;
+			auto length = static_cast<size_t>(get<uint32_t>(header, 16));
+			if (get<uint32_t>(header, 0) != JOURNAL_MAGIC || offset + JOURNAL_HEADER_SIZE + length > bytes.size())
+			{
+				break;
+			}
+
+			auto crc = crc32(0, header, JOURNAL_CRC_OFFSET);
+			crc = crc32(crc, header + JOURNAL_HEADER_SIZE, length);
+			if (crc != get<uint32_t>(header, JOURNAL_CRC_OFFSET))
+			{
+				break;
+			}
+
+			handler({ get<uint8_t>(header, 4), static_cast<JobPriorities>(get<uint8_t>(header, 5)), get<uint64_t>(header, 8), offset, header + JOURNAL_HEADER_SIZE,
+					  length });
+
+			offset += JOURNAL_HEADER_SIZE + length;
+		}
+
+		if (offset != bytes.size())
+		{
+			return { false, fmt::format("dropped {} bytes of a torn or corrupted tail at {}", bytes.size() - offset, offset) };
+		}
+
+		return { true, std::nullopt };
+	}
+
+	auto JobJournal::write(const uint8_t& type, const JobPriorities& priority, const uint64_t& id, const std::vector<uint8_t>& data)
+		-> std::tuple<std::optional<size_t>, std::optional<std::string>>
+	{
+		std::vector<uint8_t> record(JOURNAL_HEADER_SIZE + data.size());
+
+		put<uint32_t>(record.data(), 0, JOURNAL_MAGIC);
+		put<uint8_t>(record.data(), 4, type);
+		put<uint8_t>(record.data(), 5, static_cast<uint8_t>(priority));
+		put<uint16_t>(record.data(), 6, 0);
+		put<uint64_t>(record.data(), 8, id);
+		put<uint32_t>(record.data(), 16, static_cast<uint32_t>(data.size()));
+
+		if (!data.empty())
+		{
+			std::memcpy(record.data() + JOURNAL_HEADER_SIZE, data.data(), data.size());
+		}
+
+		auto crc = crc32(0, record.data(), JOURNAL_CRC_OFFSET);
+		crc = crc32(crc, record.data() + JOURNAL_HEADER_SIZE, data.size());
+		put<uint32_t>(record.data(), JOURNAL_CRC_OFFSET, crc);
+
+		// File flushes every write, so a record survives a crash of the process once this returns
+		auto [written, write_error] = writer_.write_bytes(record);
+		if (!written)
+		{
+			return { std::nullopt, write_error };
+		}
+
+		auto offset = current_size_;
+		current_size_ += record.size();
+
+		return { offset, std::nullopt };
+	}
+
+	auto JobJournal::roll(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		writer_.close();
+
+		current_segment_++;
+		current_size_ = 0;
+		segments_.insert({ current_segment_, { 0, 0 } });
+
+		auto [writable, open_error] = writer_.open(segment_path(current_segment_), std::ios::out | std::ios::binary | std::ios::app);
+		if (!writable)
+		{
+			opened_ = false;
+
+			Logger::handle().write(LogTypes::Error, fmt::format("cannot roll journal {} : {}", folder_, open_error.value_or("unknown error")));
+
+			return { false, open_error };
+		}
+
+		compact_segments();
+
+		return { true, std::nullopt };
+	}
+
+	auto JobJournal::compact_segments(void) -> void
+	{
+		// completion records may point back at older segments, so segments only ever go oldest first
+		while (!segments_.empty())
+		{
+			auto iter = segments_.begin();
+			if (iter->first == current_segment_)
+			{
+				return;
+			}
+
+			auto segment = iter->first;
+			if (iter->second.live > 0)
+			{
+				if (iter->second.live * 4 > iter->second.total)
+				{
+					return;
+				}
+
+				auto [relocated, relocate_error] = relocate(segment);
+				if (!relocated)
+				{
+					Logger::handle().write(LogTypes::Error,
+										   fmt::format("cannot relocate journal segment {} : {}", segment_path(segment), relocate_error.value_or("unknown error")));
+
+					return;
+				}
+			}
+
+			std::error_code ec;
+			std::filesystem::remove(segment_path(segment), ec);
+			if (ec)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot destroy a file : {} => {}", segment_path(segment), ec.message()));
+
+				return;
+			}
+
+			segments_.erase(segment);
+
+			Logger::handle().write(LogTypes::Parameter, fmt::format("compacted journal segment {}", segment_path(segment)));
+		}
+	}
+
+	auto JobJournal::relocate(const uint64_t& segment) -> std::tuple<bool, std::optional<std::string>>
+	{
+		std::optional<std::string> failure = std::nullopt;
+
+		auto [scanned, scan_error] = scan(segment,
+										  [this, &segment, &failure](const Record& record)
+										  {
+											  auto iter = locations_.find(record.id);
+											  if (failure != std::nullopt || record.type != JOURNAL_ENQUEUE || iter == locations_.end()
+												  || iter->second.segment != segment || iter->second.offset != record.offset)
+											  {
+												  return;
+											  }
+
+											  // the copy keeps its id, so recovery order and pending completions stay valid
+											  auto [offset, write_error] = write(JOURNAL_ENQUEUE, record.priority, record.id,
+																				 std::vector<uint8_t>(record.data, record.data + record.length));
+											  if (offset == std::nullopt)
+											  {
+												  failure = write_error.value_or("unknown error");
+
+												  return;
+											  }
+
+											  iter->second = { current_segment_, offset.value() };
+											  segments_[segment].live--;
+											  segments_[current_segment_].total++;
+											  segments_[current_segment_].live++;
+										  });
+
+		if (failure != std::nullopt)
+		{
+			return { false, failure };
+		}
+
+		if (segments_[segment].live > 0)
+		{
+			return { false, scan_error.value_or("live records are left behind") };
+		}
+
+		return { true, std::nullopt };
+	}
+} // namespace Thread
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "JobPriorities.h"
+
+#include "File.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+
+namespace Thread
+{
+	constexpr size_t JOURNAL_SEGMENT_SIZE = 64 * 1024 * 1024;
+
+	struct JournalEntry
+	{
+		uint64_t id;
+		JobPriorities priority;
+		std::vector<uint8_t> data;
+	};
+
+	// A job handed back by uncompleted_jobs. A journaled one keeps its record live until its journal_id is settled,
+	// so it should be settled only after the job has been pushed again.
+	struct UncompletedJob
+	{
+		JobPriorities priority;
+		std::vector<uint8_t> data;
+		std::optional<uint64_t> journal_id;
+	};
+
+	// Append-only journal of job payloads, split into numbered segment files inside one folder.
+	// Every record carries a CRC32, so a torn write at the tail of a segment is detected and skipped on replay.
+	// An enqueue record holds the payload and a completion record only its id; recovery is one sequential pass over the segments
+	// and leaves every record live, since only the caller knows when a recovered job is safely queued again.
+	// Segments are removed oldest first once nothing in them is live, and a mostly dead segment has its few live records
+	// moved to the tail so that one slow job cannot pin the whole history on disk.
+	class JobJournal
+	{
+	public:
+		JobJournal(const std::string& folder, const size_t& segment_size = JOURNAL_SEGMENT_SIZE);
+		virtual ~JobJournal(void);
+
+		auto open(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto close(void) -> void;
+
+		auto append(const JobPriorities& priority, const std::vector<uint8_t>& data) -> std::tuple<std::optional<uint64_t>, std::optional<std::string>>;
+		auto complete(const uint64_t& id) -> void;
+		auto read(const uint64_t& id) -> std::tuple<std::optional<std::vector<uint8_t>>, std::optional<std::string>>;
+
+		auto recover(void) -> std::vector<JournalEntry>;
+		auto compact(void) -> void;
+
+		auto folder(void) const -> const std::string;
+		auto live_count(void) -> size_t;
+
+		static auto exists(const std::string& folder) -> bool;
+
+	private:
+		struct Location
+		{
+			uint64_t segment;
+			size_t offset;
+		};
+
+		struct Segment
+		{
+			size_t total;
+			size_t live;
+		};
+
+		struct Record
+		{
+			uint8_t type;
+			JobPriorities priority;
+			uint64_t id;
+			size_t offset;
+			const uint8_t* data;
+			size_t length;
+		};
+
+		auto segment_path(const uint64_t& segment) const -> std::string;
+		auto scan(const uint64_t& segment, const std::function<void(const Record&)>& handler) -> std::tuple<bool, std::optional<std::string>>;
+		auto write(const uint8_t& type, const JobPriorities& priority, const uint64_t& id, const std::vector<uint8_t>& data)
+			-> std::tuple<std::optional<size_t>, std::optional<std::string>>;
+		auto roll(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto compact_segments(void) -> void;
+		auto relocate(const uint64_t& segment) -> std::tuple<bool, std::optional<std::string>>;
+
+	private:
+		std::mutex mutex_;
+		std::string folder_;
+		size_t segment_size_;
+
+		bool opened_;
+		uint64_t next_id_;
+		uint64_t current_segment_;
+		size_t current_size_;
+		Utilities::File writer_;
+
+		std::map<uint64_t, Segment> segments_;
+		std::unordered_map<uint64_t, Location> locations_;
+	};
+} // namespace Thread
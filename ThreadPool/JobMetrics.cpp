@@ -0,0 +1,92 @@
+#include "JobMetrics.h"
+
+namespace Thread
+{
+	JobMetrics::JobMetrics(void) { reset(); }
+
+	JobMetrics::~JobMetrics(void) {}
+
+	auto JobMetrics::record_enqueue(const JobPriorities& priority, const size_t& count) -> void
+	{
+		enqueued_[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::record_completion(const JobPriorities& priority,
+									   const std::chrono::steady_clock::time_point& enqueued_time,
+									   const std::chrono::steady_clock::time_point& started_time,
+									   const bool& succeeded) -> void
+	{
+		auto index = static_cast<size_t>(priority);
+		auto completed_time = std::chrono::steady_clock::now();
+
+		queue_waits_[index].record(std::chrono::duration_cast<std::chrono::nanoseconds>(started_time - enqueued_time));
+		executions_[index].record(std::chrono::duration_cast<std::chrono::nanoseconds>(completed_time - started_time));
+
+		if (succeeded)
+		{
+			completed_[index].fetch_add(1, std::memory_order_relaxed);
+
+			return;
+		}
+
+		failed_[index].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::record_rejected(const JobPriorities& priority, const size_t& count) -> void
+	{
+		rejected_[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::record_dropped(const JobPriorities& priority, const size_t& count) -> void
+	{
+		dropped_[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::record_spilled(const JobPriorities& priority, const size_t& count) -> void
+	{
+		spilled_[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::record_cancelled(const JobPriorities& priority, const size_t& count) -> void
+	{
+		cancelled_[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::record_coalesced(const JobPriorities& priority, const size_t& count) -> void
+	{
+		coalesced_[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+	}
+
+	auto JobMetrics::snapshot(void) const -> std::vector<PriorityMetrics>
+	{
+		std::vector<PriorityMetrics> result;
+		result.reserve(JOB_PRIORITY_COUNT);
+
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			result.push_back({ static_cast<JobPriorities>(index), enqueued_[index].load(std::memory_order_relaxed), completed_[index].load(std::memory_order_relaxed),
+							   failed_[index].load(std::memory_order_relaxed), rejected_[index].load(std::memory_order_relaxed), dropped_[index].load(std::memory_order_relaxed),
+							   spilled_[index].load(std::memory_order_relaxed), cancelled_[index].load(std::memory_order_relaxed),
+							   coalesced_[index].load(std::memory_order_relaxed), queue_waits_[index].snapshot(), executions_[index].snapshot() });
+		}
+
+		return result;
+	}
+
+	auto JobMetrics::reset(void) -> void
+	{
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			queue_waits_[index].reset();
+			executions_[index].reset();
+			enqueued_[index].store(0, std::memory_order_relaxed);
+			completed_[index].store(0, std::memory_order_relaxed);
+			failed_[index].store(0, std::memory_order_relaxed);
+			rejected_[index].store(0, std::memory_order_relaxed);
+			dropped_[index].store(0, std::memory_order_relaxed);
+			spilled_[index].store(0, std::memory_order_relaxed);
+			cancelled_[index].store(0, std::memory_order_relaxed);
+			coalesced_[index].store(0, std::memory_order_relaxed);
+		}
+	}
+} // namespace Thread
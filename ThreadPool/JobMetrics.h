@@ -0,0 +1,63 @@
+#pragma once
+
+#include "JobPriorities.h"
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace Thread
+{
+	struct PriorityMetrics
+	{
+		JobPriorities priority;
+		uint64_t enqueued;
+		uint64_t completed;
+		uint64_t failed;
+		uint64_t rejected;
+		uint64_t dropped;
+		uint64_t spilled;
+		uint64_t cancelled;
+		uint64_t coalesced;
+		LatencySnapshot queue_wait;
+		LatencySnapshot execution;
+	};
+
+	// Per-priority queue wait and execution histograms plus throughput counters for one JobPool.
+	// JobPool counts enqueues and ThreadWorker records each completion; a snapshot can be taken from any thread at any time.
+	class JobMetrics
+	{
+	public:
+		JobMetrics(void);
+		virtual ~JobMetrics(void);
+
+		auto record_enqueue(const JobPriorities& priority, const size_t& count = 1) -> void;
+		auto record_completion(const JobPriorities& priority,
+							   const std::chrono::steady_clock::time_point& enqueued_time,
+							   const std::chrono::steady_clock::time_point& started_time,
+							   const bool& succeeded) -> void;
+
+		auto record_rejected(const JobPriorities& priority, const size_t& count = 1) -> void;
+		auto record_dropped(const JobPriorities& priority, const size_t& count = 1) -> void;
+		auto record_spilled(const JobPriorities& priority, const size_t& count = 1) -> void;
+		auto record_cancelled(const JobPriorities& priority, const size_t& count = 1) -> void;
+		auto record_coalesced(const JobPriorities& priority, const size_t& count = 1) -> void;
+
+		auto snapshot(void) const -> std::vector<PriorityMetrics>;
+		auto reset(void) -> void;
+
+	private:
+		std::array<LatencyHistogram, JOB_PRIORITY_COUNT> queue_waits_;
+		std::array<LatencyHistogram, JOB_PRIORITY_COUNT> executions_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> enqueued_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> completed_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> failed_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> rejected_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> dropped_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> spilled_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> cancelled_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> coalesced_;
+	};
+} // namespace Thread
@@ -1,25 +1,76 @@
 #include "JobPool.h"
 
 #include "Converter.h"
+#include "CpuTopology.h"
 #include "File.h"
 #include "Job.h"
 #include "Logger.h"
+#include "WorkerQueue.h"
 
 #include "fmt/format.h"
 #include "fmt/xchar.h"
 
+#include <algorithm>
 #include <filesystem>
 
 using namespace Utilities;
 
 namespace Thread
 {
-	JobPool::JobPool(const std::string& title) : lock_condition_(false), job_pool_title_(title)
+	namespace
+	{
+		thread_local JobPool* current_pool_ = nullptr;
+		thread_local WorkerQueue* current_queue_ = nullptr;
+		thread_local size_t steal_index_ = 0;
+	} // namespace
+
+	JobPool::JobPool(const std::string& title, const size_t& lane_capacity)
+		: mutex_("JobPool::mutex_")
+		, job_pool_title_(title)
+		, lock_condition_(false)
+		, scheduling_mode_(SchedulingModes::Shared)
+		, metrics_(std::make_shared<JobMetrics>())
+		, lane_capacity_(lane_capacity)
+		, worker_queues_(std::make_shared<const std::vector<std::shared_ptr<WorkerQueue>>>())
+		, coalescing_count_(0)
+		, fair_share_(false)
 	{
 		backup_extensions_.insert({ ".top", JobPriorities::Top });
 		backup_extensions_.insert({ ".high", JobPriorities::High });
 		backup_extensions_.insert({ ".normal", JobPriorities::Normal });
 		backup_extensions_.insert({ ".low", JobPriorities::Low });
+
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			job_lanes_[index] = std::make_unique<LockFreeQueue<std::shared_ptr<Job>>>(lane_capacity);
+			job_counts_[index].store(0);
+			overflow_counts_[index].store(0);
+			consumed_counts_[index].store(0);
+			fair_counts_[index].store(0);
+
+			task_lanes_[index].store(nullptr);
+			task_counts_[index].store(0);
+			task_overflow_counts_[index].store(0);
+
+			capacity_policies_[index] = { 0, BackpressurePolicies::Reject, std::chrono::milliseconds(0), "", 0, 0 };
+			capacity_limits_[index].store(0);
+			backpressure_policies_[index].store(BackpressurePolicies::Reject);
+			high_watermarks_[index].store(0);
+			low_watermarks_[index].store(0);
+			blocked_producers_[index].store(0);
+			above_watermarks_[index].store(false);
+		}
+
+		std::vector<JobPriorities> all_priorities;
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			all_priorities.push_back(static_cast<JobPriorities>(index));
+		}
+
+		for (size_t node = 0; node < CpuTopology::handle().node_count(); ++node)
+		{
+			node_queues_.push_back(std::make_unique<WorkerQueue>(all_priorities));
+		}
 	}
 
 	JobPool::~JobPool(void)
@@ -27,41 +78,232 @@ namespace Thread
 		lock_condition_.store(true);
 
 		clear();
+
+		for (auto& lane : task_lanes_)
+		{
+			delete lane.exchange(nullptr);
+		}
 	}
 
 	auto JobPool::get_ptr(void) -> std::shared_ptr<JobPool> { return shared_from_this(); }
 
 	auto JobPool::clear(void) -> void
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			auto priority = static_cast<JobPriorities>(index);
+
+			std::shared_ptr<Job> target = nullptr;
+			while ((target = dequeue(priority)) != nullptr)
+			{
+				job_counts_[index].fetch_sub(1);
+
+				target->job_pool(nullptr);
+				target->destroy();
+				complete(target);
+			}
+
+			Task task;
+			while (dequeue(priority, task))
+			{
+				job_counts_[index].fetch_sub(1);
+				task.reset();
+			}
+		}
+
+		auto queues = worker_queues();
+		for (auto& queue : *queues)
+		{
+			for (auto& target : queue->clear())
+			{
+				job_counts_[static_cast<size_t>(target->priority())].fetch_sub(1);
+
+				target->job_pool(nullptr);
+				target->destroy();
+				complete(target);
+			}
+		}
 
-		for (auto job : job_queues_)
+		for (auto& queue : node_queues_)
 		{
-			for (auto target : job.second)
+			for (auto& target : queue->clear())
 			{
+				job_counts_[static_cast<size_t>(target->priority())].fetch_sub(1);
+
 				target->job_pool(nullptr);
 				target->destroy();
+				complete(target);
 			}
 		}
 
-		job_queues_.clear();
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			forget(static_cast<JobPriorities>(index));
+			relieve(static_cast<JobPriorities>(index));
+		}
 	}
 
 	auto JobPool::clear(const JobPriorities& priority) -> void
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		auto index = static_cast<size_t>(priority);
 
-		auto iterator = job_queues_.find(priority);
-		if (iterator == job_queues_.end())
+		std::vector<std::shared_ptr<Job>> targets;
+
+		auto queues = worker_queues();
+		for (auto& queue : *queues)
 		{
-			return;
+			auto cleared = queue->clear(priority);
+			targets.insert(targets.end(), cleared.begin(), cleared.end());
+		}
+
+		for (auto& queue : node_queues_)
+		{
+			auto cleared = queue->clear(priority);
+			targets.insert(targets.end(), cleared.begin(), cleared.end());
+		}
+
+		std::shared_ptr<Job> dequeued = nullptr;
+		while ((dequeued = dequeue(priority)) != nullptr)
+		{
+			targets.push_back(dequeued);
+		}
+
+		for (auto& target : targets)
+		{
+			job_counts_[index].fetch_sub(1);
+
+			target->job_pool(nullptr);
+			target->destroy();
+			complete(target);
+		}
+
+		Task task;
+		while (dequeue(priority, task))
+		{
+			job_counts_[index].fetch_sub(1);
+			task.reset();
+		}
+
+		forget(priority);
+		relieve(priority);
+	}
+
+	auto JobPool::persist(const std::string& backup_folder) -> std::tuple<size_t, std::optional<std::string>>
+	{
+		std::vector<std::shared_ptr<Job>> remained;
+		size_t discarded = 0;
+
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			auto priority = static_cast<JobPriorities>(index);
+
+			std::shared_ptr<Job> target = nullptr;
+			while ((target = dequeue(priority)) != nullptr)
+			{
+				job_counts_[index].fetch_sub(1);
+				remained.push_back(target);
+			}
+
+			// a task is a closure with nothing to write down, so it cannot outlive the process
+			Task task;
+			while (dequeue(priority, task))
+			{
+				job_counts_[index].fetch_sub(1);
+				task.reset();
+				++discarded;
+			}
+		}
+
+		auto queues = worker_queues();
+		for (auto& queue : *queues)
+		{
+			for (auto& target : queue->clear())
+			{
+				job_counts_[static_cast<size_t>(target->priority())].fetch_sub(1);
+				remained.push_back(target);
+			}
+		}
+
+		for (auto& queue : node_queues_)
+		{
+			for (auto& target : queue->clear())
+			{
+				job_counts_[static_cast<size_t>(target->priority())].fetch_sub(1);
+				remained.push_back(target);
+			}
+		}
+
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			forget(static_cast<JobPriorities>(index));
+			relieve(static_cast<JobPriorities>(index));
+		}
+
+		// Job::save places a relative folder under the temp directory, so it gets the absolute path uncompleted_jobs will read
+		std::error_code ec;
+		auto folder = std::filesystem::absolute(backup_folder, ec);
+		if (ec)
+		{
+			folder = std::filesystem::path(backup_folder);
+		}
+
+		size_t persisted = 0;
+		size_t journaled = 0;
+		for (auto& target : remained)
+		{
+			target->job_pool(nullptr);
+
+			if (target->cancelled())
+			{
+				target->destroy();
+				complete(target);
+
+				continue;
+			}
+
+			// a journaled job is already on disk and uncompleted_jobs replays it as long as it is never completed
+			if (target->journal_id() != std::nullopt)
+			{
+				++journaled;
+
+				continue;
+			}
+
+			auto [saved, save_error] = target->save(folder.string());
+			if (!saved)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot persist {} on {} : {}", target->title(), job_pool_title_, save_error.value_or("unknown error")));
+				++discarded;
+
+				continue;
+			}
+
+			++persisted;
+		}
+
+		if (persisted > 0)
+		{
+			Logger::handle().write(LogTypes::Information, fmt::format("saved {} remaining jobs of {} into {}", persisted, job_pool_title_, folder.string()));
+		}
+
+		if (journaled > 0)
+		{
+			auto journal = journal_;
+			Logger::handle().write(LogTypes::Information, fmt::format("left {} remaining jobs of {} in journal {}", journaled, job_pool_title_,
+																	  (journal != nullptr) ? journal->folder() : std::string("(closed)")));
+		}
+
+		persisted += journaled;
+
+		if (discarded > 0)
+		{
+			return { persisted, fmt::format("cannot persist {} of {} remaining jobs on {}", discarded, persisted + discarded, job_pool_title_) };
 		}
 
-		iterator->second.clear();
-		job_queues_.erase(iterator);
+		return { persisted, std::nullopt };
 	}
 
-	auto JobPool::uncompleted_jobs(const std::string& backup_folder) -> std::vector<std::vector<uint8_t>>
+	auto JobPool::uncompleted_jobs(const std::string& backup_folder) -> std::vector<UncompletedJob>
 	{
 		if (!std::filesystem::is_directory(backup_folder))
 		{
@@ -69,7 +311,29 @@ namespace Thread
 			return {};
 		}
 
-		std::vector<std::vector<uint8_t>> result;
+		std::vector<UncompletedJob> result;
+
+		// a journal is replayed in one sequential pass; the per-file scan below still picks up files written by Job::save
+		auto journal = journal_;
+		if ((journal == nullptr || std::filesystem::path(journal->folder()) != std::filesystem::path(backup_folder)) && JobJournal::exists(backup_folder))
+		{
+			journal = std::make_shared<JobJournal>(backup_folder);
+			auto [opened, open_error] = journal->open();
+			if (!opened)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot open journal {} : {}", backup_folder, open_error.value_or("unknown error")));
+				journal.reset();
+			}
+		}
+
+		if (journal != nullptr && std::filesystem::path(journal->folder()) == std::filesystem::path(backup_folder))
+		{
+			for (auto& entry : journal->recover())
+			{
+				result.push_back({ entry.priority, std::move(entry.data), entry.id });
+			}
+		}
+
 		std::chrono::system_clock::time_point file_time;
 		std::filesystem::directory_iterator iterator(backup_folder), endItr;
 
@@ -103,12 +367,48 @@ namespace Thread
 				continue;
 			}
 
-			result.push_back(source_data.value());
+			result.push_back({ iter->second, source_data.value(), std::nullopt });
 		}
 
 		return result;
 	}
 
+	auto JobPool::settle(const std::string& backup_folder, const std::vector<uint64_t>& journal_ids) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (journal_ids.empty())
+		{
+			return { true, std::nullopt };
+		}
+
+		// the pool's own journal is the only writer of its folder, so a second instance is opened only for a foreign folder
+		auto journal = journal_;
+		if (journal == nullptr || std::filesystem::path(journal->folder()) != std::filesystem::path(backup_folder))
+		{
+			if (!JobJournal::exists(backup_folder))
+			{
+				return { false, fmt::format("cannot settle recovered jobs without a journal in {}", backup_folder) };
+			}
+
+			journal = std::make_shared<JobJournal>(backup_folder);
+			auto [opened, open_error] = journal->open();
+			if (!opened)
+			{
+				return { false, fmt::format("cannot open journal {} : {}", backup_folder, open_error.value_or("unknown error")) };
+			}
+		}
+
+		for (const auto& id : journal_ids)
+		{
+			journal->complete(id);
+		}
+
+		journal->compact();
+
+		Logger::handle().write(LogTypes::Information, fmt::format("settled {} recovered jobs in journal {}", journal_ids.size(), backup_folder));
+
+		return { true, std::nullopt };
+	}
+
 	auto JobPool::push(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>
 	{
 		if (job == nullptr)
@@ -121,113 +421,1430 @@ namespace Thread
 			return { false, "the system is locked and new tasks cannot be created" };
 		}
 
-		std::unique_lock<std::mutex> lock(mutex_);
-
 		JobPriorities priority = job->priority();
+
+		if (coalesce(job))
+		{
+			return { true, std::nullopt };
+		}
+
+		auto [overflow, admit_error] = admit(priority, 1);
+		if (overflow == std::nullopt)
+		{
+			return { false, admit_error };
+		}
+
+		auto journaled = job->journal_id() != std::nullopt;
+		auto [recorded, record_error] = record(job);
+		if (!recorded)
+		{
+			withdraw(priority, 1);
+
+			return { false, record_error };
+		}
+
+		if (overflow.value() > 0)
+		{
+			auto [spilled, spill_error] = spill(job);
+			if (!spilled)
+			{
+				std::array<size_t, JOB_PRIORITY_COUNT> counts{};
+				counts[static_cast<size_t>(priority)] = 1;
+				rollback(journaled ? std::vector<std::shared_ptr<Job>>{} : std::vector<std::shared_ptr<Job>>{ job }, {}, counts);
+
+				return { false, spill_error };
+			}
+		}
+
+		track(job);
+
 		job->job_pool(get_ptr());
+		job->enqueued_time(std::chrono::steady_clock::now());
+
+		metrics_->record_enqueue(priority);
+
+		// fair sharing needs every job of a lane in the tenant queues, so it takes precedence over local queues
+		auto mode = fair_share_.load(std::memory_order_relaxed) ? SchedulingModes::Shared : scheduling_mode_.load();
+		if (mode == SchedulingModes::WorkStealing && current_pool_ == this && current_queue_ != nullptr && current_queue_->serves(priority))
+		{
+			current_queue_->push(job);
 
-		auto iter = job_queues_.find(priority);
-		if (iter != job_queues_.end())
+			Logger::handle().write(LogTypes::Parameter, fmt::format("contained local job : {} [ {} ]", job->title(), priority_string(priority)));
+		}
+		else if (mode == SchedulingModes::NodeLocal)
 		{
-			iter->second.push_back(job);
+			node_queue()->push(job);
+
+			Logger::handle().write(LogTypes::Parameter, fmt::format("contained node job : {} [ {} ]", job->title(), priority_string(priority)));
 		}
 		else
 		{
-			std::deque<std::shared_ptr<Job>> queue;
-			queue.push_back(job);
+			enqueue(job);
 
-			job_queues_.insert({ priority, queue });
+			Logger::handle().write(LogTypes::Parameter, fmt::format("contained job : {} [ {} ]", job->title(), priority_string(priority)));
 		}
 
-		Logger::handle().write(LogTypes::Parameter, fmt::format("contained job : {} [ {} ]", job->title(), priority_string(job->priority())));
-		lock.unlock();
-
 		if (notify_callback_)
 		{
-			notify_callback_(priority);
+			notify_callback_(priority, 1);
 		}
 
 		return { true, std::nullopt };
 	}
 
-	auto JobPool::pop(const std::vector<JobPriorities>& priorities) -> std::shared_ptr<Job>
+	auto JobPool::push(const std::vector<std::shared_ptr<Job>>& jobs) -> std::tuple<bool, std::optional<std::string>>
 	{
-		if (priorities.empty())
+		if (jobs.empty())
 		{
-			Logger::handle().write(LogTypes::Error, "cannot pop a job by empty priorities");
+			return { false, "cannot push empty jobs" };
+		}
 
-			return nullptr;
+		if (std::find(jobs.begin(), jobs.end(), nullptr) != jobs.end())
+		{
+			return { false, "cannot push empty job" };
 		}
 
-		std::scoped_lock<std::mutex> lock(mutex_);
+		if (lock_condition_.load())
+		{
+			return { false, "the system is locked and new tasks cannot be created" };
+		}
 
-		for (const auto& priority : priorities)
+		// keyed jobs fold into a queued job, or into an earlier job of the same batch, before any slot is admitted
+		std::vector<std::shared_ptr<Job>> targets;
+		std::array<std::unordered_map<std::string, size_t>, JOB_PRIORITY_COUNT> batch_keys;
+		targets.reserve(jobs.size());
+		for (auto& job : jobs)
 		{
-			auto iter = job_queues_.find(priority);
-			if (iter == job_queues_.end() || iter->second.empty())
+			if (coalesce(job))
 			{
 				continue;
 			}
 
-			std::shared_ptr<Job> result = iter->second.front();
-			if (result == nullptr)
+			auto key = job->coalescing_key();
+			if (key.empty())
 			{
+				targets.push_back(job);
 				continue;
 			}
 
-			iter->second.pop_front();
+			auto index = static_cast<size_t>(job->priority());
+			auto [iter, inserted] = batch_keys[index].insert({ key, targets.size() });
+			if (inserted)
+			{
+				targets.push_back(job);
+				continue;
+			}
 
-			Logger::handle().write(LogTypes::Parameter,
-								   fmt::format("consumed job : {} [ {} ] for {}", result->title(), priority_string(result->priority()), priority_string(priorities)));
+			targets[iter->second] = targets[iter->second]->coalesce(job);
+			metrics_->record_coalesced(job->priority());
+		}
 
-			return result;
+		if (targets.empty())
+		{
+			return { true, std::nullopt };
 		}
 
-		Logger::handle().write(LogTypes::Sequence, fmt::format("there is no pop job by priorities : {}", priority_string(priorities)));
+		std::array<size_t, JOB_PRIORITY_COUNT> counts{};
+		for (auto& job : targets)
+		{
+			counts[static_cast<size_t>(job->priority())]++;
+		}
 
-		return nullptr;
-	}
+		// admission is all or nothing: a lane that cannot take its share returns the slots of the lanes admitted before it
+		std::array<size_t, JOB_PRIORITY_COUNT> overflows{};
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			if (counts[index] == 0)
+			{
+				continue;
+			}
 
-	auto JobPool::notify_callback(const std::function<void(const JobPriorities&)>& callback) -> void { notify_callback_ = callback; }
+			auto [overflow, admit_error] = admit(static_cast<JobPriorities>(index), counts[index]);
+			if (overflow != std::nullopt)
+			{
+				overflows[index] = overflow.value();
+				continue;
+			}
 
-	auto JobPool::job_pool_title(const std::string& title) -> void { job_pool_title_ = title; }
+			for (size_t admitted = 0; admitted < index; ++admitted)
+			{
+				if (counts[admitted] > 0)
+				{
+					withdraw(static_cast<JobPriorities>(admitted), counts[admitted]);
+				}
+			}
 
-	const std::string JobPool::job_pool_title(void) { return job_pool_title_; }
+			return { false, admit_error };
+		}
 
-	auto JobPool::job_count(std::vector<JobPriorities>& priorities) -> const size_t
-	{
-		if (priorities.empty())
+		// like a single push, a batch that cannot be journaled or spilled in full is rejected with nothing left behind
+		std::vector<std::shared_ptr<Job>> recorded_jobs;
+		for (auto& job : targets)
 		{
-			std::scoped_lock<std::mutex> lock(mutex_);
+			auto journaled = job->journal_id() != std::nullopt;
+			auto [recorded, record_error] = record(job);
+			if (!recorded)
+			{
+				rollback(recorded_jobs, {}, counts);
 
-			size_t count = 0;
+				return { false, record_error };
+			}
 
-			for (auto& current : job_queues_)
+			if (!journaled && job->journal_id() != std::nullopt)
 			{
-				count += current.second.size();
+				recorded_jobs.push_back(job);
 			}
+		}
 
-			return count;
+		// the newest jobs of an overflowing lane are the ones that go to disk
+		std::vector<std::shared_ptr<Job>> spilled_jobs;
+		for (auto iter = targets.rbegin(); iter != targets.rend(); ++iter)
+		{
+			auto index = static_cast<size_t>((*iter)->priority());
+			if (overflows[index] == 0)
+			{
+				continue;
+			}
+
+			auto [spilled, spill_error] = spill(*iter);
+			if (!spilled)
+			{
+				rollback(recorded_jobs, spilled_jobs, counts);
+
+				return { false, spill_error };
+			}
+
+			spilled_jobs.push_back(*iter);
+			overflows[index]--;
 		}
 
-		size_t count = 0;
-		for (auto& priority : priorities)
+		auto pool = get_ptr();
+		auto enqueued_time = std::chrono::steady_clock::now();
+
+		for (auto& job : targets)
 		{
-			std::scoped_lock<std::mutex> lock(mutex_);
+			track(job);
+			job->job_pool(pool);
+			job->enqueued_time(enqueued_time);
+		}
 
-			auto iter = job_queues_.find(priority);
-			if (iter == job_queues_.end())
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			if (counts[index] > 0)
+			{
+				metrics_->record_enqueue(static_cast<JobPriorities>(index), counts[index]);
+			}
+		}
+
+		// a batch comes from one producer, so in NodeLocal mode all of it stays on that producer's node
+		auto fair_share = fair_share_.load(std::memory_order_relaxed);
+		auto local_queue = (!fair_share && scheduling_mode_.load() == SchedulingModes::NodeLocal) ? node_queue() : nullptr;
+
+		std::array<bool, JOB_PRIORITY_COUNT> overflowed{};
+		std::vector<std::shared_ptr<Job>> remained;
+		for (auto& job : targets)
+		{
+			if (fair_share)
+			{
+				enqueue_fair(job);
+				continue;
+			}
+
+			if (local_queue != nullptr)
+			{
+				local_queue->push(job);
+				continue;
+			}
+
+			auto index = static_cast<size_t>(job->priority());
+			if (!overflowed[index] && overflow_counts_[index].load() == 0 && job_lanes_[index]->push(job))
 			{
 				continue;
 			}
 
-			count += iter->second.size();
+			overflowed[index] = true;
+			remained.push_back(job);
 		}
 
-		return count;
-	}
+		if (!remained.empty())
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
-	auto JobPool::lock(const bool& condition) -> void { lock_condition_.store(condition); }
+			for (auto& job : remained)
+			{
+				job_queues_[job->priority()].push_back(job);
+				overflow_counts_[static_cast<size_t>(job->priority())].fetch_add(1);
+			}
+		}
 
-	auto JobPool::lock(void) -> const bool { return lock_condition_.load(); }
+		Logger::handle().write(LogTypes::Parameter, fmt::format("contained {} jobs", targets.size()));
+
+		if (!notify_callback_)
+		{
+			return { true, std::nullopt };
+		}
+
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			if (counts[index] > 0)
+			{
+				notify_callback_(static_cast<JobPriorities>(index), counts[index]);
+			}
+		}
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::push(const JobPriorities& priority, Task&& task) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (!task)
+		{
+			return { false, "cannot push empty task" };
+		}
+
+		if (lock_condition_.load())
+		{
+			return { false, "the system is locked and new tasks cannot be created" };
+		}
+
+		auto index = static_cast<size_t>(priority);
+
+		auto [overflow, admit_error] = admit(priority, 1);
+		if (overflow == std::nullopt)
+		{
+			return { false, admit_error };
+		}
+
+		if (overflow.value() > 0)
+		{
+			withdraw(priority, 1);
+			metrics_->record_rejected(priority);
+
+			return { false, fmt::format("cannot spill a task on the full {} lane", priority_string(priority)) };
+		}
+
+		task.priority(priority);
+		task.enqueued_time(std::chrono::steady_clock::now());
+
+		task_counts_[index].fetch_add(1);
+		metrics_->record_enqueue(priority);
+
+		if (task_overflow_counts_[index].load() != 0 || !task_lane(priority)->push(std::move(task)))
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			task_queues_[priority].push_back(std::move(task));
+			task_overflow_counts_[index].fetch_add(1);
+		}
+
+		if (notify_callback_)
+		{
+			notify_callback_(priority, 1);
+		}
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::pop(const std::vector<JobPriorities>& priorities) -> std::shared_ptr<Job>
+	{
+		Task ignored;
+
+		return pop(priorities, ignored, false);
+	}
+
+	auto JobPool::pop(const std::vector<JobPriorities>& priorities, Task& task) -> std::shared_ptr<Job> { return pop(priorities, task, true); }
+
+	auto JobPool::pop(const std::vector<JobPriorities>& priorities, const size_t& batch_size, std::vector<std::shared_ptr<Job>>& jobs, std::vector<Task>& tasks)
+		-> size_t
+	{
+		if (priorities.empty())
+		{
+			Logger::handle().write(LogTypes::Error, "cannot pop jobs by empty priorities");
+
+			return 0;
+		}
+
+		bool work_stealing = (scheduling_mode_.load() == SchedulingModes::WorkStealing);
+		auto local_queue = node_queued() ? node_queue() : nullptr;
+
+		// a batch never mixes priorities, so a higher lane that fills up meanwhile is not kept waiting behind lower work
+		for (const auto& priority : priorities)
+		{
+			while (jobs.size() + tasks.size() < batch_size)
+			{
+				Task task;
+				auto result = take(priority, task, true, work_stealing, local_queue);
+				if (task)
+				{
+					tasks.push_back(std::move(task));
+					continue;
+				}
+
+				if (result == nullptr)
+				{
+					break;
+				}
+
+				jobs.push_back(result);
+			}
+
+			if (!jobs.empty() || !tasks.empty())
+			{
+				Logger::handle().write(LogTypes::Parameter, fmt::format("consumed {} jobs and {} tasks [ {} ] for {}", jobs.size(), tasks.size(), priority_string(priority),
+																		priority_string(priorities)));
+
+				return jobs.size() + tasks.size();
+			}
+		}
+
+		Logger::handle().write(LogTypes::Sequence, fmt::format("there is no pop job by priorities : {}", priority_string(priorities)));
+
+		return 0;
+	}
+
+	auto JobPool::notify_callback(const std::function<void(const JobPriorities&, const size_t&)>& callback) -> void { notify_callback_ = callback; }
+
+	auto JobPool::metrics(void) -> std::shared_ptr<JobMetrics> { return metrics_; }
+
+	auto JobPool::capacity(const JobPriorities& priority, const CapacityPolicy& policy) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (policy.high_watermark > 0 && policy.low_watermark >= policy.high_watermark)
+		{
+			return { false, "cannot set a low watermark that is not below the high watermark" };
+		}
+
+		if (policy.limit > 0 && policy.policy == BackpressurePolicies::Spill && policy.spill_folder.empty())
+		{
+			return { false, "cannot spill without a folder" };
+		}
+
+		auto index = static_cast<size_t>(priority);
+
+		std::scoped_lock<std::mutex> lock(capacity_mutex_);
+
+		capacity_policies_[index] = policy;
+		backpressure_policies_[index].store(policy.policy);
+		high_watermarks_[index].store(policy.high_watermark);
+		low_watermarks_[index].store(policy.low_watermark);
+		capacity_limits_[index].store(policy.limit);
+
+		// a raised limit may let blocked producers through right away
+		capacity_condition_.notify_all();
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::capacity(const JobPriorities& priority) -> CapacityPolicy
+	{
+		std::scoped_lock<std::mutex> lock(capacity_mutex_);
+
+		return capacity_policies_[static_cast<size_t>(priority)];
+	}
+
+	auto JobPool::watermark_callback(const std::function<void(const JobPriorities&, const bool&)>& callback) -> void { watermark_callback_ = callback; }
+
+	auto JobPool::journal(const std::string& folder, const size_t& segment_size) -> std::tuple<bool, std::optional<std::string>>
+	{
+		auto journal = std::make_shared<JobJournal>(folder, segment_size);
+
+		auto [opened, open_error] = journal->open();
+		if (!opened)
+		{
+			return { false, open_error };
+		}
+
+		journal_ = journal;
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::complete(std::shared_ptr<Job> job) -> void
+	{
+		if (journal_ == nullptr || job == nullptr)
+		{
+			return;
+		}
+
+		auto id = job->journal_id();
+		if (id == std::nullopt)
+		{
+			return;
+		}
+
+		journal_->complete(id.value());
+	}
+
+	auto JobPool::register_tenant(const std::string& tenant, const size_t& weight) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (weight == 0)
+		{
+			return { false, fmt::format("cannot register tenant {} with zero weight", tenant) };
+		}
+
+		for (auto& lane : fair_lanes_)
+		{
+			std::scoped_lock<std::mutex> lock(lane.mutex);
+
+			// untagged jobs and jobs of unknown tenants share the default tenant with a weight of one
+			if (lane.tenants.find("") == lane.tenants.end())
+			{
+				lane.tenants.insert({ "", std::make_unique<TenantQueue>(TenantQueue{ 1, 0, false, {} }) });
+			}
+
+			auto iter = lane.tenants.find(tenant);
+			if (iter != lane.tenants.end())
+			{
+				iter->second->weight = weight;
+				continue;
+			}
+
+			lane.tenants.insert({ tenant, std::make_unique<TenantQueue>(TenantQueue{ weight, 0, false, {} }) });
+		}
+
+		fair_share_.store(true);
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("registered tenant {} with weight {} on {}", tenant, weight, job_pool_title_));
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::unregister_tenant(const std::string& tenant) -> bool
+	{
+		if (tenant.empty())
+		{
+			return false;
+		}
+
+		bool removed = false;
+		bool remained = false;
+
+		for (auto& lane : fair_lanes_)
+		{
+			std::scoped_lock<std::mutex> lock(lane.mutex);
+
+			auto iter = lane.tenants.find(tenant);
+			if (iter == lane.tenants.end())
+			{
+				continue;
+			}
+
+			// queued jobs of the tenant move over to the default tenant instead of being lost
+			auto& default_tenant = lane.tenants.at("");
+			auto& target = iter->second;
+			default_tenant->jobs.insert(default_tenant->jobs.end(), target->jobs.begin(), target->jobs.end());
+			if (!default_tenant->jobs.empty() && !default_tenant->active)
+			{
+				default_tenant->active = true;
+				lane.active_tenants.push_back(default_tenant.get());
+			}
+
+			lane.active_tenants.erase(std::remove(lane.active_tenants.begin(), lane.active_tenants.end(), target.get()), lane.active_tenants.end());
+			lane.tenants.erase(iter);
+			removed = true;
+
+			remained = remained || lane.tenants.size() > 1;
+		}
+
+		if (removed && !remained)
+		{
+			fair_share_.store(false);
+		}
+
+		return removed;
+	}
+
+	auto JobPool::attach(std::shared_ptr<WorkerQueue> queue) -> void
+	{
+		if (queue == nullptr)
+		{
+			return;
+		}
+
+		{
+			std::scoped_lock<std::mutex> lock(worker_queues_mutex_);
+
+			auto queues = std::make_shared<std::vector<std::shared_ptr<WorkerQueue>>>(*worker_queues_);
+			queues->push_back(queue);
+			worker_queues_ = queues;
+		}
+
+		current_pool_ = this;
+		current_queue_ = queue.get();
+	}
+
+	auto JobPool::detach(std::shared_ptr<WorkerQueue> queue) -> void
+	{
+		if (queue == nullptr)
+		{
+			return;
+		}
+
+		{
+			std::scoped_lock<std::mutex> lock(worker_queues_mutex_);
+
+			auto queues = std::make_shared<std::vector<std::shared_ptr<WorkerQueue>>>(*worker_queues_);
+			queues->erase(std::remove(queues->begin(), queues->end(), queue), queues->end());
+			worker_queues_ = queues;
+		}
+
+		if (current_queue_ == queue.get())
+		{
+			current_pool_ = nullptr;
+			current_queue_ = nullptr;
+		}
+
+		auto remained = queue->clear();
+		if (remained.empty())
+		{
+			return;
+		}
+
+		for (auto& job : remained)
+		{
+			enqueue(job);
+		}
+
+		if (notify_callback_)
+		{
+			for (auto& job : remained)
+			{
+				notify_callback_(job->priority(), 1);
+			}
+		}
+	}
+
+	auto JobPool::scheduling_mode(const SchedulingModes& mode) -> void { scheduling_mode_.store(mode); }
+
+	auto JobPool::scheduling_mode(void) -> const SchedulingModes { return scheduling_mode_.load(); }
+
+	auto JobPool::job_pool_title(const std::string& title) -> void { job_pool_title_ = title; }
+
+	const std::string JobPool::job_pool_title(void) { return job_pool_title_; }
+
+	auto JobPool::job_count(std::vector<JobPriorities>& priorities) -> const size_t
+	{
+		size_t count = 0;
+
+		if (priorities.empty())
+		{
+			for (auto& current : job_counts_)
+			{
+				count += current.load(std::memory_order_relaxed);
+			}
+
+			return count;
+		}
+
+		for (auto& priority : priorities)
+		{
+			count += job_counts_[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+		}
+
+		return count;
+	}
+
+	auto JobPool::job_count(const JobPriorities& priority) -> const size_t { return job_counts_[static_cast<size_t>(priority)].load(std::memory_order_relaxed); }
+
+	auto JobPool::consumed_count(const JobPriorities& priority) -> const uint64_t
+	{
+		return consumed_counts_[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+	}
+
+	auto JobPool::lock(const bool& condition) -> void
+	{
+		lock_condition_.store(condition);
+
+		if (!condition)
+		{
+			return;
+		}
+
+		std::scoped_lock<std::mutex> lock(capacity_mutex_);
+
+		capacity_condition_.notify_all();
+	}
+
+	auto JobPool::lock(void) -> const bool { return lock_condition_.load(); }
+
+	auto JobPool::enqueue(std::shared_ptr<Job> job) -> void
+	{
+		if (fair_share_.load(std::memory_order_relaxed))
+		{
+			enqueue_fair(job);
+
+			return;
+		}
+
+		auto index = static_cast<size_t>(job->priority());
+
+		if (overflow_counts_[index].load() == 0 && job_lanes_[index]->push(job))
+		{
+			return;
+		}
+
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		job_queues_[job->priority()].push_back(job);
+		overflow_counts_[index].fetch_add(1);
+	}
+
+	auto JobPool::dequeue(const JobPriorities& priority) -> std::shared_ptr<Job>
+	{
+		auto index = static_cast<size_t>(priority);
+
+		std::shared_ptr<Job> result = nullptr;
+		if (job_lanes_[index]->pop(result))
+		{
+			return result;
+		}
+
+		if (overflow_counts_[index].load() > 0)
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			auto iter = job_queues_.find(priority);
+			if (iter != job_queues_.end() && !iter->second.empty())
+			{
+				result = iter->second.front();
+				iter->second.pop_front();
+				overflow_counts_[index].fetch_sub(1);
+
+				return result;
+			}
+		}
+
+		// jobs queued before the first tenant was registered drain through the lane above before fair sharing starts
+		if (fair_counts_[index].load() > 0)
+		{
+			return dequeue_fair(priority);
+		}
+
+		return nullptr;
+	}
+
+	auto JobPool::pop(const std::vector<JobPriorities>& priorities, Task& task, const bool& with_task) -> std::shared_ptr<Job>
+	{
+		if (priorities.empty())
+		{
+			Logger::handle().write(LogTypes::Error, "cannot pop a job by empty priorities");
+
+			return nullptr;
+		}
+
+		bool work_stealing = (scheduling_mode_.load() == SchedulingModes::WorkStealing);
+		auto local_queue = node_queued() ? node_queue() : nullptr;
+
+		for (const auto& priority : priorities)
+		{
+			auto result = take(priority, task, with_task, work_stealing, local_queue);
+			if (result == nullptr && !task)
+			{
+				continue;
+			}
+
+			if (result != nullptr)
+			{
+				Logger::handle().write(LogTypes::Parameter,
+									   fmt::format("consumed job : {} [ {} ] for {}", result->title(), priority_string(result->priority()), priority_string(priorities)));
+			}
+
+			return result;
+		}
+
+		Logger::handle().write(LogTypes::Sequence, fmt::format("there is no pop job by priorities : {}", priority_string(priorities)));
+
+		return nullptr;
+	}
+
+	auto JobPool::take(const JobPriorities& priority, Task& task, const bool& with_task, const bool& work_stealing, WorkerQueue* local_queue) -> std::shared_ptr<Job>
+	{
+		auto index = static_cast<size_t>(priority);
+
+		// cancelled and expired jobs are discarded here, so a stale backlog is drained without running any of it
+		while (true)
+		{
+			if (job_counts_[index].load(std::memory_order_relaxed) == 0)
+			{
+				return nullptr;
+			}
+
+			if (with_task && task_counts_[index].load(std::memory_order_relaxed) > 0 && dequeue(priority, task))
+			{
+				job_counts_[index].fetch_sub(1);
+				consumed_counts_[index].fetch_add(1, std::memory_order_relaxed);
+				relieve(priority);
+
+				return nullptr;
+			}
+
+			std::shared_ptr<Job> result = (local_queue != nullptr) ? local_queue->pop(priority) : nullptr;
+			if (result == nullptr && work_stealing && current_pool_ == this && current_queue_ != nullptr)
+			{
+				result = current_queue_->pop(priority);
+			}
+
+			if (result == nullptr)
+			{
+				result = dequeue(priority);
+			}
+
+			if (result == nullptr && work_stealing)
+			{
+				result = steal(priority);
+			}
+
+			if (result == nullptr && local_queue != nullptr)
+			{
+				result = steal_node(priority, local_queue);
+			}
+
+			if (result == nullptr)
+			{
+				return nullptr;
+			}
+
+			job_counts_[index].fetch_sub(1);
+			consumed_counts_[index].fetch_add(1, std::memory_order_relaxed);
+			relieve(priority);
+
+			if (coalescing_count_.load(std::memory_order_relaxed) > 0)
+			{
+				result = release(result);
+			}
+
+			if (!result->cancelled())
+			{
+				return result;
+			}
+
+			Logger::handle().write(LogTypes::Sequence, fmt::format("discarded cancelled job {} [ {} ]", result->title(), priority_string(priority)));
+
+			result->destroy();
+			complete(result);
+			metrics_->record_cancelled(priority);
+		}
+	}
+
+	auto JobPool::dequeue(const JobPriorities& priority, Task& task) -> bool
+	{
+		auto index = static_cast<size_t>(priority);
+
+		auto lane = task_lanes_[index].load(std::memory_order_acquire);
+		if (lane != nullptr && lane->pop(task))
+		{
+			task_counts_[index].fetch_sub(1);
+
+			return true;
+		}
+
+		if (task_overflow_counts_[index].load() == 0)
+		{
+			return false;
+		}
+
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		auto iter = task_queues_.find(priority);
+		if (iter == task_queues_.end() || iter->second.empty())
+		{
+			return false;
+		}
+
+		task = std::move(iter->second.front());
+		iter->second.pop_front();
+		task_overflow_counts_[index].fetch_sub(1);
+		task_counts_[index].fetch_sub(1);
+
+		return true;
+	}
+
+	auto JobPool::task_lane(const JobPriorities& priority) -> LockFreeQueue<Task>*
+	{
+		auto& target = task_lanes_[static_cast<size_t>(priority)];
+
+		auto lane = target.load(std::memory_order_acquire);
+		if (lane != nullptr)
+		{
+			return lane;
+		}
+
+		auto created = new LockFreeQueue<Task>(lane_capacity_);
+		if (target.compare_exchange_strong(lane, created, std::memory_order_acq_rel))
+		{
+			return created;
+		}
+
+		delete created;
+
+		return lane;
+	}
+
+	auto JobPool::steal(const JobPriorities& priority) -> std::shared_ptr<Job>
+	{
+		auto queues = worker_queues();
+		if (queues->empty())
+		{
+			return nullptr;
+		}
+
+		size_t count = queues->size();
+		size_t start = steal_index_++;
+		for (size_t index = 0; index < count; ++index)
+		{
+			auto& victim = (*queues)[(start + index) % count];
+			if (victim.get() == current_queue_)
+			{
+				continue;
+			}
+
+			auto result = victim->steal(priority);
+			if (result != nullptr)
+			{
+				Logger::handle().write(LogTypes::Sequence, fmt::format("stole job : {} [ {} ]", result->title(), priority_string(priority)));
+
+				return result;
+			}
+		}
+
+		return nullptr;
+	}
+
+	auto JobPool::node_queue(void) -> WorkerQueue*
+	{
+		if (node_queues_.size() == 1)
+		{
+			return node_queues_.front().get();
+		}
+
+		return node_queues_[CpuTopology::handle().current_node() % node_queues_.size()].get();
+	}
+
+	auto JobPool::node_queued(void) -> bool
+	{
+		// jobs pushed in NodeLocal mode stay on their node queue after a mode change, so those are still drained
+		if (scheduling_mode_.load(std::memory_order_relaxed) == SchedulingModes::NodeLocal)
+		{
+			return true;
+		}
+
+		for (auto& queue : node_queues_)
+		{
+			if (queue->job_count() > 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	auto JobPool::steal_node(const JobPriorities& priority, WorkerQueue* local_queue) -> std::shared_ptr<Job>
+	{
+		// remote nodes are drained in FIFO order, so a starving node still sees their oldest jobs first
+		for (auto& queue : node_queues_)
+		{
+			if (queue.get() == local_queue)
+			{
+				continue;
+			}
+
+			auto result = queue->pop(priority);
+			if (result != nullptr)
+			{
+				return result;
+			}
+		}
+
+		return nullptr;
+	}
+
+	auto JobPool::admit(const JobPriorities& priority, const size_t& count) -> std::tuple<std::optional<size_t>, std::optional<std::string>>
+	{
+		auto index = static_cast<size_t>(priority);
+
+		auto limit = capacity_limits_[index].load(std::memory_order_relaxed);
+		if (limit == 0)
+		{
+			job_counts_[index].fetch_add(count);
+			relieve(priority);
+
+			return { 0, std::nullopt };
+		}
+
+		size_t overflow = 0;
+		switch (backpressure_policies_[index].load(std::memory_order_relaxed))
+		{
+		case BackpressurePolicies::Reject:
+			if (!reserve(index, count, limit))
+			{
+				metrics_->record_rejected(priority, count);
+
+				return { std::nullopt, fmt::format("the {} lane is full at {} jobs", priority_string(priority), limit) };
+			}
+			break;
+		case BackpressurePolicies::Block:
+			if (!reserve(index, count, limit))
+			{
+				auto [reserved, wait_error] = wait_for_capacity(priority, count, limit);
+				if (!reserved)
+				{
+					metrics_->record_rejected(priority, count);
+
+					return { std::nullopt, wait_error };
+				}
+			}
+			break;
+		case BackpressurePolicies::DropOldest:
+		{
+			auto previous = job_counts_[index].fetch_add(count);
+			auto excess = (previous + count > limit) ? std::min(count, previous + count - limit) : 0;
+
+			size_t dropped = 0;
+			while (dropped < excess && drop_oldest(priority))
+			{
+				++dropped;
+			}
+
+			if (dropped > 0)
+			{
+				metrics_->record_dropped(priority, dropped);
+
+				Logger::handle().write(LogTypes::Information, fmt::format("dropped {} oldest jobs on the full {} lane", dropped, priority_string(priority)));
+			}
+
+			// the rest of the lane is still in flight from other producers, so the bound is kept by turning these jobs away
+			if (dropped < excess)
+			{
+				withdraw(priority, count);
+				metrics_->record_rejected(priority, count);
+
+				return { std::nullopt, fmt::format("the {} lane is full at {} jobs and has nothing left to drop", priority_string(priority), limit) };
+			}
+		}
+		break;
+		case BackpressurePolicies::Spill:
+		{
+			auto previous = job_counts_[index].fetch_add(count);
+			overflow = (previous + count > limit) ? std::min(count, previous + count - limit) : 0;
+		}
+		break;
+		}
+
+		relieve(priority);
+
+		return { overflow, std::nullopt };
+	}
+
+	auto JobPool::reserve(const size_t& index, const size_t& count, const size_t& limit) -> bool
+	{
+		auto current = job_counts_[index].load();
+		do
+		{
+			if (current + count > limit)
+			{
+				return false;
+			}
+		} while (!job_counts_[index].compare_exchange_weak(current, current + count));
+
+		return true;
+	}
+
+	auto JobPool::wait_for_capacity(const JobPriorities& priority, const size_t& count, const size_t& limit) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (count > limit)
+		{
+			return { false, fmt::format("cannot fit {} jobs into the {} lane limited to {}", count, priority_string(priority), limit) };
+		}
+
+		auto index = static_cast<size_t>(priority);
+
+		std::unique_lock<std::mutex> lock(capacity_mutex_);
+
+		auto timeout = capacity_policies_[index].block_timeout;
+
+		bool locked = false;
+		auto ready = [&]()
+		{
+			if (lock_condition_.load())
+			{
+				locked = true;
+
+				return true;
+			}
+
+			// the limit may have been changed or lifted while this producer was waiting
+			auto current_limit = capacity_limits_[index].load();
+			if (current_limit == 0)
+			{
+				job_counts_[index].fetch_add(count);
+
+				return true;
+			}
+
+			return reserve(index, count, current_limit);
+		};
+
+		// the waiter count is raised under the lock before checking, so a consumer that frees a slot either sees it or is seen
+		blocked_producers_[index].fetch_add(1);
+		auto reserved = (timeout.count() > 0) ? capacity_condition_.wait_for(lock, timeout, ready) : (capacity_condition_.wait(lock, ready), true);
+		blocked_producers_[index].fetch_sub(1);
+
+		if (locked)
+		{
+			return { false, "the system is locked and new tasks cannot be created" };
+		}
+
+		if (!reserved)
+		{
+			return { false, fmt::format("timed out after {} ms waiting for room on the {} lane", timeout.count(), priority_string(priority)) };
+		}
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::drop_oldest(const JobPriorities& priority) -> bool
+	{
+		auto index = static_cast<size_t>(priority);
+
+		auto target = dequeue(priority);
+
+		// WorkStealing and NodeLocal keep queued jobs in per-worker and per-node queues, whose front is the oldest
+		if (target == nullptr)
+		{
+			auto queues = worker_queues();
+			for (auto& queue : *queues)
+			{
+				if ((target = queue->pop(priority)) != nullptr)
+				{
+					break;
+				}
+			}
+		}
+
+		for (size_t node = 0; target == nullptr && node < node_queues_.size(); ++node)
+		{
+			target = node_queues_[node]->pop(priority);
+		}
+
+		if (target != nullptr)
+		{
+			job_counts_[index].fetch_sub(1);
+
+			target->job_pool(nullptr);
+			target->destroy();
+			complete(target);
+
+			auto current = release(target);
+			if (current != target)
+			{
+				current->job_pool(nullptr);
+				current->destroy();
+				complete(current);
+			}
+
+			return true;
+		}
+
+		Task task;
+		if (!dequeue(priority, task))
+		{
+			return false;
+		}
+
+		job_counts_[index].fetch_sub(1);
+		task.reset();
+
+		return true;
+	}
+
+	auto JobPool::spill(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>
+	{
+		std::string folder;
+		{
+			std::scoped_lock<std::mutex> lock(capacity_mutex_);
+
+			folder = capacity_policies_[static_cast<size_t>(job->priority())].spill_folder;
+		}
+
+		// a journaled payload is already on disk, so spilling it only drops the copy in memory
+		auto [saved, save_error] = (job->journal_id() != std::nullopt) ? job->offload() : job->save(folder);
+		if (!saved)
+		{
+			return { false, save_error };
+		}
+
+		metrics_->record_spilled(job->priority());
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::withdraw(const JobPriorities& priority, const size_t& count) -> void
+	{
+		job_counts_[static_cast<size_t>(priority)].fetch_sub(count);
+
+		relieve(priority);
+	}
+
+	auto JobPool::record(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (journal_ == nullptr || job->journal_id() != std::nullopt)
+		{
+			return { true, std::nullopt };
+		}
+
+		// only the payload can be replayed, so jobs without data have nothing to journal
+		if (job->data().empty())
+		{
+			return { true, std::nullopt };
+		}
+
+		auto [id, append_error] = journal_->append(job->priority(), job->data());
+		if (id == std::nullopt)
+		{
+			return { false, append_error };
+		}
+
+		job->journal(journal_, id.value());
+
+		return { true, std::nullopt };
+	}
+
+	auto JobPool::rollback(const std::vector<std::shared_ptr<Job>>& recorded,
+						   const std::vector<std::shared_ptr<Job>>& spilled,
+						   const std::array<size_t, JOB_PRIORITY_COUNT>& counts) -> void
+	{
+		// payloads come back into memory before their records go, since an offloaded job can only be read from the journal
+		for (auto& job : spilled)
+		{
+			auto [restored, restore_error] = job->restore();
+			if (!restored)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot restore {} [ {} ] : {}", job->title(), priority_string(job->priority()),
+																	restore_error.value_or("unknown error")));
+			}
+		}
+
+		for (auto& job : recorded)
+		{
+			complete(job);
+			job->journal(nullptr, std::nullopt);
+		}
+
+		for (size_t index = 0; index < JOB_PRIORITY_COUNT; ++index)
+		{
+			if (counts[index] > 0)
+			{
+				withdraw(static_cast<JobPriorities>(index), counts[index]);
+			}
+		}
+	}
+
+	auto JobPool::relieve(const JobPriorities& priority) -> void
+	{
+		auto index = static_cast<size_t>(priority);
+
+		if (blocked_producers_[index].load() > 0)
+		{
+			std::scoped_lock<std::mutex> lock(capacity_mutex_);
+
+			capacity_condition_.notify_all();
+		}
+
+		auto high_watermark = high_watermarks_[index].load(std::memory_order_relaxed);
+		if (high_watermark == 0 || !watermark_callback_)
+		{
+			return;
+		}
+
+		auto count = job_counts_[index].load(std::memory_order_relaxed);
+		if (count >= high_watermark)
+		{
+			if (!above_watermarks_[index].load(std::memory_order_relaxed) && !above_watermarks_[index].exchange(true))
+			{
+				watermark_callback_(priority, true);
+			}
+
+			return;
+		}
+
+		if (count <= low_watermarks_[index].load(std::memory_order_relaxed) && above_watermarks_[index].load(std::memory_order_relaxed)
+			&& above_watermarks_[index].exchange(false))
+		{
+			watermark_callback_(priority, false);
+		}
+	}
+
+	auto JobPool::coalesce(std::shared_ptr<Job> job) -> bool
+	{
+		auto key = job->coalescing_key();
+		if (key.empty())
+		{
+			return false;
+		}
+
+		auto priority = job->priority();
+
+		std::scoped_lock<std::mutex> lock(coalescing_mutex_);
+
+		auto& jobs = coalesced_jobs_[static_cast<size_t>(priority)];
+		auto iter = jobs.find(key);
+		if (iter == jobs.end())
+		{
+			return false;
+		}
+
+		// current is only reachable through this map until its queued job is popped, so it can be changed under this lock
+		auto previous = iter->second.current;
+		iter->second.current = previous->coalesce(job);
+		metrics_->record_coalesced(priority);
+
+		if (iter->second.current != previous && journal_ != nullptr)
+		{
+			auto [recorded, record_error] = record(iter->second.current);
+			if (recorded)
+			{
+				complete(previous);
+			}
+		}
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("coalesced job : {} [ {} ] by {}", job->title(), priority_string(priority), key));
+
+		return true;
+	}
+
+	auto JobPool::track(std::shared_ptr<Job> job) -> void
+	{
+		auto key = job->coalescing_key();
+		if (key.empty())
+		{
+			return;
+		}
+
+		std::scoped_lock<std::mutex> lock(coalescing_mutex_);
+
+		// a racing producer may have queued the same key first; this job then simply runs on its own
+		auto [iter, inserted] = coalesced_jobs_[static_cast<size_t>(job->priority())].insert({ key, { job, job } });
+		if (inserted)
+		{
+			coalescing_count_.fetch_add(1);
+		}
+	}
+
+	auto JobPool::release(std::shared_ptr<Job> job) -> std::shared_ptr<Job>
+	{
+		auto key = job->coalescing_key();
+		if (key.empty())
+		{
+			return job;
+		}
+
+		std::shared_ptr<Job> current = nullptr;
+
+		{
+			std::scoped_lock<std::mutex> lock(coalescing_mutex_);
+
+			auto& jobs = coalesced_jobs_[static_cast<size_t>(job->priority())];
+			auto iter = jobs.find(key);
+			if (iter == jobs.end() || iter->second.queued != job)
+			{
+				return job;
+			}
+
+			current = iter->second.current;
+			jobs.erase(iter);
+			coalescing_count_.fetch_sub(1);
+		}
+
+		if (current != job)
+		{
+			current->job_pool(get_ptr());
+			current->enqueued_time(job->enqueued_time());
+		}
+
+		return current;
+	}
+
+	auto JobPool::forget(const JobPriorities& priority) -> void
+	{
+		std::scoped_lock<std::mutex> lock(coalescing_mutex_);
+
+		auto& jobs = coalesced_jobs_[static_cast<size_t>(priority)];
+		coalescing_count_.fetch_sub(jobs.size());
+		jobs.clear();
+	}
+
+	auto JobPool::enqueue_fair(std::shared_ptr<Job> job) -> void
+	{
+		auto index = static_cast<size_t>(job->priority());
+		auto& lane = fair_lanes_[index];
+
+		std::scoped_lock<std::mutex> lock(lane.mutex);
+
+		auto iter = lane.tenants.find(job->tenant());
+		if (iter == lane.tenants.end())
+		{
+			iter = lane.tenants.find("");
+		}
+
+		if (iter == lane.tenants.end())
+		{
+			iter = lane.tenants.insert({ "", std::make_unique<TenantQueue>(TenantQueue{ 1, 0, false, {} }) }).first;
+		}
+
+		auto& target = iter->second;
+		target->jobs.push_back(job);
+		fair_counts_[index].fetch_add(1);
+
+		if (!target->active)
+		{
+			target->active = true;
+			lane.active_tenants.push_back(target.get());
+		}
+	}
+
+	auto JobPool::dequeue_fair(const JobPriorities& priority) -> std::shared_ptr<Job>
+	{
+		auto index = static_cast<size_t>(priority);
+		auto& lane = fair_lanes_[index];
+
+		std::scoped_lock<std::mutex> lock(lane.mutex);
+
+		if (lane.active_tenants.empty())
+		{
+			return nullptr;
+		}
+
+		auto target = lane.active_tenants.front();
+		if (target->deficit == 0)
+		{
+			target->deficit = target->weight;
+		}
+
+		auto result = target->jobs.front();
+		target->jobs.pop_front();
+		target->deficit--;
+		fair_counts_[index].fetch_sub(1);
+
+		if (target->jobs.empty())
+		{
+			// an idle tenant does not bank its unused share for later
+			target->active = false;
+			target->deficit = 0;
+			lane.active_tenants.pop_front();
+		}
+		else if (target->deficit == 0)
+		{
+			lane.active_tenants.pop_front();
+			lane.active_tenants.push_back(target);
+		}
+
+		return result;
+	}
+
+	auto JobPool::worker_queues(void) -> std::shared_ptr<const std::vector<std::shared_ptr<WorkerQueue>>>
+	{
+		std::scoped_lock<std::mutex> lock(worker_queues_mutex_);
+
+		return worker_queues_;
+	}
 } // namespace Thread
\ No newline at end of file
@@ -1,51 +1,193 @@
 #pragma once
 
 #include "JobPriorities.h"
+#include "InstrumentedMutex.h"
+#include "SchedulingModes.h"
+#include "LockFreeQueue.h"
+#include "JobMetrics.h"
+#include "BackpressurePolicies.h"
+#include "JobJournal.h"
+#include "Task.h"
 
 #include <map>
+#include <array>
 #include <deque>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <condition_variable>
 
 namespace Thread
 {
 	class Job;
+	class WorkerQueue;
+
+	// A limit of zero leaves the lane unbounded. Block waits up to block_timeout, or until the pool locks when it is zero.
+	// Spill keeps accepting jobs but saves the payload of every job above the limit through Job::save into spill_folder.
+	// The watermark callback fires once when the lane reaches high_watermark and once when it drains back to low_watermark.
+	struct CapacityPolicy
+	{
+		size_t limit;
+		BackpressurePolicies policy;
+		std::chrono::milliseconds block_timeout;
+		std::string spill_folder;
+		size_t high_watermark;
+		size_t low_watermark;
+	};
+
 	class JobPool : public std::enable_shared_from_this<JobPool>
 	{
 	public:
-		JobPool(const std::string& job_pool_title = "JobPool");
+		JobPool(const std::string& job_pool_title = "JobPool", const size_t& lane_capacity = 256);
 		virtual ~JobPool(void);
 
 		auto get_ptr(void) -> std::shared_ptr<JobPool>;
 
 		auto clear(void) -> void;
 		auto clear(const JobPriorities& priority) -> void;
-		auto uncompleted_jobs(const std::string& backup_folder) -> std::vector<std::vector<uint8_t>>;
+		auto uncompleted_jobs(const std::string& backup_folder) -> std::vector<UncompletedJob>;
+		auto settle(const std::string& backup_folder, const std::vector<uint64_t>& journal_ids) -> std::tuple<bool, std::optional<std::string>>;
+		auto persist(const std::string& backup_folder) -> std::tuple<size_t, std::optional<std::string>>;
 
 		auto push(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>;
+		auto push(const std::vector<std::shared_ptr<Job>>& jobs) -> std::tuple<bool, std::optional<std::string>>;
+		auto push(const JobPriorities& priority, Task&& task) -> std::tuple<bool, std::optional<std::string>>;
 		auto pop(const std::vector<JobPriorities>& priorities) -> std::shared_ptr<Job>;
+		auto pop(const std::vector<JobPriorities>& priorities, Task& task) -> std::shared_ptr<Job>;
+		auto pop(const std::vector<JobPriorities>& priorities, const size_t& batch_size, std::vector<std::shared_ptr<Job>>& jobs, std::vector<Task>& tasks) -> size_t;
+
+		auto notify_callback(const std::function<void(const JobPriorities&, const size_t&)>& callback) -> void;
+		auto metrics(void) -> std::shared_ptr<JobMetrics>;
+
+		auto capacity(const JobPriorities& priority, const CapacityPolicy& policy) -> std::tuple<bool, std::optional<std::string>>;
+		auto capacity(const JobPriorities& priority) -> CapacityPolicy;
+		auto watermark_callback(const std::function<void(const JobPriorities&, const bool&)>& callback) -> void;
 
-		auto notify_callback(const std::function<void(const JobPriorities&)>& callback) -> void;
+		auto journal(const std::string& folder, const size_t& segment_size = JOURNAL_SEGMENT_SIZE) -> std::tuple<bool, std::optional<std::string>>;
+		auto complete(std::shared_ptr<Job> job) -> void;
+
+		auto register_tenant(const std::string& tenant, const size_t& weight) -> std::tuple<bool, std::optional<std::string>>;
+		auto unregister_tenant(const std::string& tenant) -> bool;
+
+		auto attach(std::shared_ptr<WorkerQueue> queue) -> void;
+		auto detach(std::shared_ptr<WorkerQueue> queue) -> void;
+
+		auto scheduling_mode(const SchedulingModes& mode) -> void;
+		auto scheduling_mode(void) -> const SchedulingModes;
 
 		auto job_pool_title(const std::string& title) -> void;
 		auto job_pool_title(void) -> const std::string;
 
 		auto job_count(std::vector<JobPriorities>& priorities) -> const size_t;
+		auto job_count(const JobPriorities& priority) -> const size_t;
+		auto consumed_count(const JobPriorities& priority) -> const uint64_t;
 
 		auto lock(const bool& condition) -> void;
 		auto lock(void) -> const bool;
 
 	private:
-		std::mutex mutex_;
+		auto pop(const std::vector<JobPriorities>& priorities, Task& task, const bool& with_task) -> std::shared_ptr<Job>;
+		auto take(const JobPriorities& priority, Task& task, const bool& with_task, const bool& work_stealing, WorkerQueue* local_queue) -> std::shared_ptr<Job>;
+		auto enqueue(std::shared_ptr<Job> job) -> void;
+		auto dequeue(const JobPriorities& priority) -> std::shared_ptr<Job>;
+		auto dequeue(const JobPriorities& priority, Task& task) -> bool;
+		auto task_lane(const JobPriorities& priority) -> LockFreeQueue<Task>*;
+		auto steal(const JobPriorities& priority) -> std::shared_ptr<Job>;
+		auto node_queue(void) -> WorkerQueue*;
+		auto node_queued(void) -> bool;
+		auto steal_node(const JobPriorities& priority, WorkerQueue* local_queue) -> std::shared_ptr<Job>;
+		auto worker_queues(void) -> std::shared_ptr<const std::vector<std::shared_ptr<WorkerQueue>>>;
+
+		auto admit(const JobPriorities& priority, const size_t& count) -> std::tuple<std::optional<size_t>, std::optional<std::string>>;
+		auto reserve(const size_t& index, const size_t& count, const size_t& limit) -> bool;
+		auto wait_for_capacity(const JobPriorities& priority, const size_t& count, const size_t& limit) -> std::tuple<bool, std::optional<std::string>>;
+		auto drop_oldest(const JobPriorities& priority) -> bool;
+		auto spill(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>;
+		auto withdraw(const JobPriorities& priority, const size_t& count) -> void;
+		auto record(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>;
+		auto rollback(const std::vector<std::shared_ptr<Job>>& recorded,
+					  const std::vector<std::shared_ptr<Job>>& spilled,
+					  const std::array<size_t, JOB_PRIORITY_COUNT>& counts) -> void;
+		auto relieve(const JobPriorities& priority) -> void;
+
+		auto coalesce(std::shared_ptr<Job> job) -> bool;
+		auto track(std::shared_ptr<Job> job) -> void;
+		auto release(std::shared_ptr<Job> job) -> std::shared_ptr<Job>;
+		auto forget(const JobPriorities& priority) -> void;
+
+		auto enqueue_fair(std::shared_ptr<Job> job) -> void;
+		auto dequeue_fair(const JobPriorities& priority) -> std::shared_ptr<Job>;
+
+	private:
+		InstrumentedMutex mutex_;
+		std::mutex worker_queues_mutex_;
 		std::string job_pool_title_;
 		std::atomic_bool lock_condition_;
-		std::function<void(const JobPriorities&)> notify_callback_;
+		std::atomic<SchedulingModes> scheduling_mode_;
+		std::function<void(const JobPriorities&, const size_t&)> notify_callback_;
+		std::shared_ptr<JobMetrics> metrics_;
+		std::shared_ptr<JobJournal> journal_;
 		std::map<std::string, JobPriorities> backup_extensions_;
 		std::map<JobPriorities, std::deque<std::shared_ptr<Job>>> job_queues_;
+		std::array<std::unique_ptr<LockFreeQueue<std::shared_ptr<Job>>>, JOB_PRIORITY_COUNT> job_lanes_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> job_counts_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> overflow_counts_;
+		std::array<std::atomic<uint64_t>, JOB_PRIORITY_COUNT> consumed_counts_;
+
+		size_t lane_capacity_;
+		std::map<JobPriorities, std::deque<Task>> task_queues_;
+		std::array<std::atomic<LockFreeQueue<Task>*>, JOB_PRIORITY_COUNT> task_lanes_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> task_counts_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> task_overflow_counts_;
+		std::shared_ptr<const std::vector<std::shared_ptr<WorkerQueue>>> worker_queues_;
+		std::vector<std::unique_ptr<WorkerQueue>> node_queues_;
+
+		std::mutex capacity_mutex_;
+		std::condition_variable capacity_condition_;
+		std::array<CapacityPolicy, JOB_PRIORITY_COUNT> capacity_policies_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> capacity_limits_;
+		std::array<std::atomic<BackpressurePolicies>, JOB_PRIORITY_COUNT> backpressure_policies_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> high_watermarks_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> low_watermarks_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> blocked_producers_;
+		std::array<std::atomic_bool, JOB_PRIORITY_COUNT> above_watermarks_;
+		std::function<void(const JobPriorities&, const bool&)> watermark_callback_;
+
+		// queued is the job sitting in the lane and current is the one that will run when it is popped
+		struct CoalescedJob
+		{
+			std::shared_ptr<Job> queued;
+			std::shared_ptr<Job> current;
+		};
+
+		std::mutex coalescing_mutex_;
+		std::atomic<size_t> coalescing_count_;
+		std::array<std::unordered_map<std::string, CoalescedJob>, JOB_PRIORITY_COUNT> coalesced_jobs_;
+
+		// deficit round robin with a cost of one per job: an active tenant is served up to weight jobs per turn
+		struct TenantQueue
+		{
+			size_t weight;
+			size_t deficit;
+			bool active;
+			std::deque<std::shared_ptr<Job>> jobs;
+		};
+
+		struct FairShareLane
+		{
+			std::mutex mutex;
+			std::unordered_map<std::string, std::unique_ptr<TenantQueue>> tenants;
+			std::deque<TenantQueue*> active_tenants;
+		};
+
+		std::atomic_bool fair_share_;
+		std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> fair_counts_;
+		std::array<FairShareLane, JOB_PRIORITY_COUNT> fair_lanes_;
 	};
 } // namespace Thread
\ No newline at end of file
@@ -15,6 +15,8 @@ namespace Thread
 		LongTerm,
 	};
 
+	constexpr size_t JOB_PRIORITY_COUNT = static_cast<size_t>(JobPriorities::LongTerm) + 1;
+
 	auto priority_string(const JobPriorities& priority) -> const std::string;
 	auto priority_string(const std::vector<JobPriorities>& priorities) -> const std::string;
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "LockFreeQueue.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace Thread
+{
+	struct RecyclerCounters
+	{
+		uint64_t created;
+		uint64_t reused;
+		uint64_t released;
+	};
+
+	// Freelist of Job objects for high-rate producers.
+	// acquire() hands out a recycled instance re-armed through T::reset(args...) when one is available
+	// and constructs T(args...) otherwise. When the last shared_ptr goes away the job is wiped through
+	// T::recycle() and parked in the freelist, so buffers and callback storage keep their capacity.
+	template <typename T> class JobRecycler : public std::enable_shared_from_this<JobRecycler<T>>
+	{
+	public:
+		JobRecycler(const size_t& capacity = 256) : freelist_(capacity), created_(0), reused_(0), released_(0) {}
+
+		JobRecycler(const JobRecycler&) = delete;
+		JobRecycler& operator=(const JobRecycler&) = delete;
+
+		virtual ~JobRecycler(void)
+		{
+			T* item = nullptr;
+			while (freelist_.pop(item))
+			{
+				delete item;
+			}
+		}
+
+		template <typename... Args> auto acquire(Args&&... args) -> std::shared_ptr<T>
+		{
+			T* item = nullptr;
+			if (freelist_.pop(item))
+			{
+				item->reset(std::forward<Args>(args)...);
+				reused_.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				item = new T(std::forward<Args>(args)...);
+				created_.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			return std::shared_ptr<T>(item, Releaser{ this->weak_from_this() });
+		}
+
+		auto counters(void) const -> RecyclerCounters
+		{
+			return { created_.load(std::memory_order_relaxed), reused_.load(std::memory_order_relaxed), released_.load(std::memory_order_relaxed) };
+		}
+
+	private:
+		struct Releaser
+		{
+			std::weak_ptr<JobRecycler<T>> recycler;
+
+			auto operator()(T* item) const -> void
+			{
+				auto target = recycler.lock();
+				if (target == nullptr)
+				{
+					delete item;
+
+					return;
+				}
+
+				target->release(item);
+			}
+		};
+
+		auto release(T* item) -> void
+		{
+			item->recycle();
+
+			if (!freelist_.push(item))
+			{
+				delete item;
+
+				return;
+			}
+
+			released_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+	private:
+		LockFreeQueue<T*> freelist_;
+
+		std::atomic<uint64_t> created_;
+		std::atomic<uint64_t> reused_;
+		std::atomic<uint64_t> released_;
+	};
+} // namespace Thread
@@ -0,0 +1,114 @@
+#include "LatencyHistogram.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace Thread
+{
+	LatencyHistogram::LatencyHistogram(void) : sum_(0), max_(0) { reset(); }
+
+	LatencyHistogram::~LatencyHistogram(void) {}
+
+	auto LatencyHistogram::record(const std::chrono::nanoseconds& latency) -> void
+	{
+		auto value = static_cast<uint64_t>(latency.count() > 0 ? latency.count() : 0);
+
+		buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+		sum_.fetch_add(value, std::memory_order_relaxed);
+
+		auto current = max_.load(std::memory_order_relaxed);
+		while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	auto LatencyHistogram::snapshot(void) const -> LatencySnapshot
+	{
+		// buckets are read one by one while writers keep recording, so the result is consistent per bucket only
+		std::vector<uint64_t> counts(LATENCY_BUCKET_COUNT);
+
+		uint64_t total = 0;
+		for (size_t index = 0; index < LATENCY_BUCKET_COUNT; ++index)
+		{
+			counts[index] = buckets_[index].load(std::memory_order_relaxed);
+			total += counts[index];
+		}
+
+		LatencySnapshot result{ total, std::chrono::nanoseconds(0), std::chrono::nanoseconds(0), std::chrono::nanoseconds(0), std::chrono::nanoseconds(0),
+								std::chrono::nanoseconds(max_.load(std::memory_order_relaxed)) };
+		if (total == 0)
+		{
+			return result;
+		}
+
+		result.mean = std::chrono::nanoseconds(sum_.load(std::memory_order_relaxed) / total);
+
+		const std::array<std::pair<double, std::chrono::nanoseconds*>, 3> targets = { { { 0.5, &result.p50 }, { 0.99, &result.p99 }, { 0.999, &result.p999 } } };
+
+		uint64_t cumulative = 0;
+		size_t target = 0;
+		for (size_t index = 0; index < LATENCY_BUCKET_COUNT && target < targets.size(); ++index)
+		{
+			cumulative += counts[index];
+
+			while (target < targets.size() && cumulative >= static_cast<uint64_t>(targets[target].first * static_cast<double>(total - 1)) + 1)
+			{
+				*targets[target].second = std::chrono::nanoseconds(std::min(bucket_value(index), static_cast<uint64_t>(result.max.count())));
+				++target;
+			}
+		}
+
+		return result;
+	}
+
+	auto LatencyHistogram::reset(void) -> void
+	{
+		for (auto& bucket : buckets_)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+
+		sum_.store(0, std::memory_order_relaxed);
+		max_.store(0, std::memory_order_relaxed);
+	}
+
+	auto LatencyHistogram::bucket_index(const uint64_t& value) -> size_t
+	{
+		if (value < LATENCY_SUB_BUCKETS)
+		{
+			return static_cast<size_t>(value);
+		}
+
+		size_t exponent = 0;
+		for (auto remained = value; remained > 1; remained >>= 1)
+		{
+			++exponent;
+		}
+
+		if (exponent > LATENCY_MAX_EXPONENT)
+		{
+			return LATENCY_BUCKET_COUNT - 1;
+		}
+
+		// the leading bit selects the row and the next four bits select the bucket inside it
+		auto shift = exponent - LATENCY_SUB_BUCKET_BITS;
+		auto sub_bucket = static_cast<size_t>(value >> shift) - LATENCY_SUB_BUCKETS;
+
+		return (shift + 1) * LATENCY_SUB_BUCKETS + sub_bucket;
+	}
+
+	auto LatencyHistogram::bucket_value(const size_t& index) -> uint64_t
+	{
+		if (index < LATENCY_SUB_BUCKETS)
+		{
+			return static_cast<uint64_t>(index);
+		}
+
+		auto shift = index / LATENCY_SUB_BUCKETS - 1;
+		auto sub_bucket = static_cast<uint64_t>(index % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS);
+
+		// the highest value that still falls into this bucket, so percentiles never under-report
+		return ((sub_bucket + 1) << shift) - 1;
+	}
+} // namespace Thread
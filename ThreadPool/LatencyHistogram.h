@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Thread
+{
+	constexpr size_t LATENCY_SUB_BUCKET_BITS = 4;
+	constexpr size_t LATENCY_SUB_BUCKETS = static_cast<size_t>(1) << LATENCY_SUB_BUCKET_BITS;
+	constexpr size_t LATENCY_MAX_EXPONENT = 40;
+	constexpr size_t LATENCY_BUCKET_COUNT = (LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS + 2) * LATENCY_SUB_BUCKETS;
+
+	struct LatencySnapshot
+	{
+		uint64_t count;
+		std::chrono::nanoseconds mean;
+		std::chrono::nanoseconds p50;
+		std::chrono::nanoseconds p99;
+		std::chrono::nanoseconds p999;
+		std::chrono::nanoseconds max;
+	};
+
+	// Log-linear histogram of nanosecond latencies in the spirit of HdrHistogram.
+	// Every power of two is split into 16 buckets, so a reported percentile is within about 6% of the recorded value,
+	// up to 2^40 ns (about 18 minutes) where samples saturate. Recording is a relaxed fetch_add and never blocks.
+	class LatencyHistogram
+	{
+	public:
+		LatencyHistogram(void);
+		virtual ~LatencyHistogram(void);
+
+		auto record(const std::chrono::nanoseconds& latency) -> void;
+		auto snapshot(void) const -> LatencySnapshot;
+		auto reset(void) -> void;
+
+	private:
+		static auto bucket_index(const uint64_t& value) -> size_t;
+		static auto bucket_value(const size_t& index) -> uint64_t;
+
+	private:
+		std::atomic<uint64_t> sum_;
+		std::atomic<uint64_t> max_;
+		std::array<std::atomic<uint64_t>, LATENCY_BUCKET_COUNT> buckets_;
+	};
+} // namespace Thread
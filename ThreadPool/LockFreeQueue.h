@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace Thread
+{
+	// Bounded multi-producer/multi-consumer ring buffer (D. Vyukov).
+	// Every cell carries a sequence number, so push and pop only contend on a single
+	// compare-and-swap of their own position counter and never take a lock.
+	template <typename T> class LockFreeQueue
+	{
+	public:
+		LockFreeQueue(const size_t& capacity) : mask_(0), cells_(nullptr), enqueue_position_(0), dequeue_position_(0)
+		{
+			size_t target = 2;
+			while (target < capacity)
+			{
+				target <<= 1;
+			}
+
+			mask_ = target - 1;
+			cells_ = std::make_unique<Cell[]>(target);
+			for (size_t index = 0; index < target; ++index)
+			{
+				cells_[index].sequence.store(index, std::memory_order_relaxed);
+			}
+		}
+
+		LockFreeQueue(const LockFreeQueue&) = delete;
+		LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+		virtual ~LockFreeQueue(void) = default;
+
+		auto push(T&& item) -> bool
+		{
+			Cell* cell = nullptr;
+			size_t position = enqueue_position_.load(std::memory_order_relaxed);
+			while (true)
+			{
+				cell = &cells_[position & mask_];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+				if (difference == 0)
+				{
+					if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+
+					continue;
+				}
+
+				if (difference < 0)
+				{
+					return false;
+				}
+
+				position = enqueue_position_.load(std::memory_order_relaxed);
+			}
+
+			cell->data = std::move(item);
+			cell->sequence.store(position + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		auto push(const T& item) -> bool
+		{
+			T copied = item;
+
+			return push(std::move(copied));
+		}
+
+		auto pop(T& item) -> bool
+		{
+			Cell* cell = nullptr;
+			size_t position = dequeue_position_.load(std::memory_order_relaxed);
+			while (true)
+			{
+				cell = &cells_[position & mask_];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+				if (difference == 0)
+				{
+					if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						break;
+					}
+
+					continue;
+				}
+
+				if (difference < 0)
+				{
+					return false;
+				}
+
+				position = dequeue_position_.load(std::memory_order_relaxed);
+			}
+
+			item = std::move(cell->data);
+			cell->data = T();
+			cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		auto capacity(void) const -> size_t { return mask_ + 1; }
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			T data;
+		};
+
+		size_t mask_;
+		std::unique_ptr<Cell[]> cells_;
+
+		alignas(64) std::atomic<size_t> enqueue_position_;
+		alignas(64) std::atomic<size_t> dequeue_position_;
+	};
+} // namespace Thread
@@ -0,0 +1,62 @@
+#include "LockProfiler.h"
+
+namespace Thread
+{
+	LockProfiler::LockProfiler(void) {}
+
+	LockProfiler::~LockProfiler(void) {}
+
+	auto LockProfiler::counters(const std::string& name) -> std::shared_ptr<LockCounters>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto& target = counters_[name];
+		if (target == nullptr)
+		{
+			target = std::make_shared<LockCounters>();
+		}
+
+		return target;
+	}
+
+	auto LockProfiler::snapshot(void) -> std::vector<LockStatistics>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		std::vector<LockStatistics> result;
+		result.reserve(counters_.size());
+
+		for (const auto& [name, target] : counters_)
+		{
+			result.push_back({ name, target->acquisitions.load(std::memory_order_relaxed), target->contended.load(std::memory_order_relaxed),
+							   target->wait.snapshot(), target->hold.snapshot() });
+		}
+
+		return result;
+	}
+
+	auto LockProfiler::reset(void) -> void
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		for (auto& [name, target] : counters_)
+		{
+			target->acquisitions.store(0, std::memory_order_relaxed);
+			target->contended.store(0, std::memory_order_relaxed);
+			target->wait.reset();
+			target->hold.reset();
+		}
+	}
+
+#pragma region Handle
+	std::unique_ptr<LockProfiler> LockProfiler::handle_;
+	std::once_flag LockProfiler::once_;
+
+	LockProfiler& LockProfiler::handle(void)
+	{
+		std::call_once(once_, []() { handle_.reset(new LockProfiler); });
+
+		return *handle_.get();
+	}
+#pragma endregion
+} // namespace Thread
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Thread
+{
+	struct LockStatistics
+	{
+		std::string name;
+		uint64_t acquisitions;
+		uint64_t contended;
+		LatencySnapshot wait;
+		LatencySnapshot hold;
+	};
+
+	struct LockCounters
+	{
+		std::atomic<uint64_t> acquisitions{ 0 };
+		std::atomic<uint64_t> contended{ 0 };
+		LatencyHistogram wait;
+		LatencyHistogram hold;
+	};
+
+	// Process-wide registry of InstrumentedMutex counters, keyed by lock name.
+	// Every mutex created with the same name feeds the same counters, so all ThreadWorker instances report as one lock.
+	// Nothing is registered unless the library is built with USE_LOCK_PROFILING, so without it snapshot is always empty.
+	class LockProfiler
+	{
+	private:
+		LockProfiler(void);
+
+	public:
+		virtual ~LockProfiler(void);
+
+		auto counters(const std::string& name) -> std::shared_ptr<LockCounters>;
+		auto snapshot(void) -> std::vector<LockStatistics>;
+		auto reset(void) -> void;
+
+	private:
+		std::mutex mutex_;
+		std::map<std::string, std::shared_ptr<LockCounters>> counters_;
+
+#pragma region Handle
+	public:
+		static LockProfiler& handle(void);
+
+	private:
+		static std::unique_ptr<LockProfiler> handle_;
+		static std::once_flag once_;
+#pragma endregion
+	};
+} // namespace Thread
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "Task.h"
+#include "ThreadPool.h"
+#include "JobPriorities.h"
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <exception>
+#include <condition_variable>
+
+namespace Thread
+{
+	// Shared by the caller and the helper Tasks of one parallel call.
+	// Chunks are claimed from a single cursor with guided sizes: large while much work remains,
+	// shrinking to the grain near the end, so idle participants keep taking the leftovers.
+	// wait() returns once every item is settled, so a helper that starts late only finds an exhausted cursor.
+	class ParallelRange
+	{
+	public:
+		ParallelRange(const size_t& count, const size_t& grain, const size_t& participants)
+			: count_(count), grain_(std::max<size_t>(grain, 1)), participants_(std::max<size_t>(participants, 1)), cursor_(0), settled_(0), failed_(false)
+		{
+		}
+
+		template <typename Chunk> auto run(Chunk& chunk) -> void
+		{
+			size_t first = 0;
+			size_t last = 0;
+			while (claim(first, last))
+			{
+				try
+				{
+					chunk(first, last);
+				}
+				catch (...)
+				{
+					fail(std::current_exception());
+				}
+
+				settle(last - first);
+			}
+		}
+
+		auto wait(void) -> void
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return settled_.load(std::memory_order_acquire) == count_; });
+
+			if (exception_ != nullptr)
+			{
+				std::rethrow_exception(exception_);
+			}
+		}
+
+	private:
+		auto claim(size_t& first, size_t& last) -> bool
+		{
+			size_t current = cursor_.load(std::memory_order_acquire);
+			while (current < count_)
+			{
+				size_t remaining = count_ - current;
+				size_t size = std::min(remaining, std::max(grain_, remaining / (participants_ * 2)));
+				if (cursor_.compare_exchange_weak(current, current + size, std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					first = current;
+					last = current + size;
+
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		auto settle(const size_t& size) -> void
+		{
+			if (settled_.fetch_add(size, std::memory_order_acq_rel) + size != count_)
+			{
+				return;
+			}
+
+			std::scoped_lock<std::mutex> lock(mutex_);
+			condition_.notify_all();
+		}
+
+		auto fail(std::exception_ptr exception) -> void
+		{
+			if (!failed_.exchange(true))
+			{
+				std::scoped_lock<std::mutex> lock(mutex_);
+				exception_ = exception;
+			}
+
+			// the unclaimed tail is settled without running, so wait() does not hang on items nobody will take
+			size_t skipped = cursor_.exchange(count_, std::memory_order_acq_rel);
+			if (skipped < count_)
+			{
+				settle(count_ - skipped);
+			}
+		}
+
+	private:
+		size_t count_;
+		size_t grain_;
+		size_t participants_;
+
+		std::atomic<size_t> cursor_;
+		std::atomic<size_t> settled_;
+		std::atomic<bool> failed_;
+		std::exception_ptr exception_;
+
+		std::mutex mutex_;
+		std::condition_variable condition_;
+	};
+
+	// Runs chunk(first, last) over [0, count) on the workers serving priority and on the calling thread.
+	// The caller keeps claiming chunks itself and only blocks for chunks already running elsewhere,
+	// so it also works when called from inside a ThreadWorker.
+	template <typename Chunk>
+	auto parallel_chunks(std::shared_ptr<ThreadPool> pool, const JobPriorities& priority, const size_t& count, const size_t& grain, Chunk&& chunk) -> void
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		size_t helpers = (pool == nullptr) ? 0 : pool->worker_count(priority);
+		helpers = std::min(helpers, (count + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1) - 1);
+
+		struct Context
+		{
+			Context(const size_t& count, const size_t& grain, const size_t& participants, Chunk& target) : range(count, grain, participants), chunk(target) {}
+
+			ParallelRange range;
+			Chunk& chunk;
+		};
+
+		auto context = std::make_shared<Context>(count, grain, helpers + 1, chunk);
+		for (size_t index = 0; index < helpers; ++index)
+		{
+			auto [pushed, message] = pool->push(priority, Task([context]() { context->range.run(context->chunk); }));
+			if (!pushed)
+			{
+				break;
+			}
+		}
+
+		context->range.run(context->chunk);
+		context->range.wait();
+	}
+
+	template <typename Function>
+	auto parallel_for(std::shared_ptr<ThreadPool> pool, const JobPriorities& priority, const size_t& first, const size_t& last, Function&& function, const size_t& grain = 1)
+		-> void
+	{
+		if (last <= first)
+		{
+			return;
+		}
+
+		parallel_chunks(pool, priority, last - first, grain,
+						[&function, first](const size_t& begin, const size_t& end)
+						{
+							for (size_t index = first + begin; index < first + end; ++index)
+							{
+								function(index);
+							}
+						});
+	}
+
+	template <typename InputIterator, typename OutputIterator, typename Function>
+	auto parallel_transform(std::shared_ptr<ThreadPool> pool,
+							const JobPriorities& priority,
+							InputIterator first,
+							InputIterator last,
+							OutputIterator output,
+							Function&& function,
+							const size_t& grain = 1) -> OutputIterator
+	{
+		auto count = static_cast<size_t>(std::distance(first, last));
+
+		parallel_chunks(pool, priority, count, grain,
+						[&function, first, output](const size_t& begin, const size_t& end)
+						{
+							auto source = std::next(first, begin);
+							auto target = std::next(output, begin);
+							for (size_t index = begin; index < end; ++index, ++source, ++target)
+							{
+								*target = function(*source);
+							}
+						});
+
+		return std::next(output, count);
+	}
+
+	// combine must be associative; partial results are folded in range order, so it need not be commutative.
+	template <typename Iterator, typename T, typename Combine>
+	auto parallel_reduce(
+		std::shared_ptr<ThreadPool> pool, const JobPriorities& priority, Iterator first, Iterator last, T identity, Combine&& combine, const size_t& grain = 1) -> T
+	{
+		auto count = static_cast<size_t>(std::distance(first, last));
+
+		std::mutex mutex;
+		std::vector<std::pair<size_t, T>> partials;
+
+		parallel_chunks(pool, priority, count, grain,
+						[&combine, &mutex, &partials, &identity, first](const size_t& begin, const size_t& end)
+						{
+							auto source = std::next(first, begin);
+
+							T partial = identity;
+							for (size_t index = begin; index < end; ++index, ++source)
+							{
+								partial = combine(std::move(partial), *source);
+							}
+
+							std::scoped_lock<std::mutex> lock(mutex);
+							partials.emplace_back(begin, std::move(partial));
+						});
+
+		std::sort(partials.begin(), partials.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+
+		T result = std::move(identity);
+		for (auto& partial : partials)
+		{
+			result = combine(std::move(result), std::move(partial.second));
+		}
+
+		return result;
+	}
+} // namespace Thread
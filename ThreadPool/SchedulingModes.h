@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Thread
+{
+	enum class SchedulingModes : uint8_t { Shared, WorkStealing, NodeLocal };
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "Strand.h"
+
+#include "Logger.h"
+#include "ThreadPool.h"
+
+#include "fmt/format.h"
+#include "fmt/xchar.h"
+
+#include <thread>
+#include <utility>
+
+using namespace Utilities;
+
+namespace Thread
+{
+	namespace
+	{
+		// the strand whose schedule call is on this thread's stack, since that caller handles a rejected drain itself
+		thread_local const Strand* scheduling_ = nullptr;
+	} // namespace
+
+	// Drain task that owns the right to consume the strand; if the pool drops it unrun, the backlog is discarded instead
+	class Strand::DrainTask
+	{
+	public:
+		DrainTask(std::shared_ptr<Strand> strand) : strand_(std::move(strand)) {}
+
+		DrainTask(DrainTask&& other) noexcept : strand_(std::move(other.strand_)) {}
+
+		DrainTask(const DrainTask&) = delete;
+		DrainTask& operator=(const DrainTask&) = delete;
+		DrainTask& operator=(DrainTask&&) = delete;
+
+		~DrainTask(void)
+		{
+			if (strand_ == nullptr || scheduling_ == strand_.get())
+			{
+				return;
+			}
+
+			strand_->discard();
+		}
+
+		auto operator()(void) -> void { std::exchange(strand_, nullptr)->drain(); }
+
+	private:
+		std::shared_ptr<Strand> strand_;
+	};
+
+	Strand::Strand(std::shared_ptr<ThreadPool> pool, const JobPriorities& priority, const std::string& title)
+		: title_(title), priority_(priority), pool_(pool), pending_(0), head_(nullptr), tail_(nullptr)
+	{
+		// the stub node keeps head and tail non-null, so producers never touch the consumer side
+		auto stub = new Node();
+		stub->next.store(nullptr, std::memory_order_relaxed);
+
+		head_.store(stub, std::memory_order_relaxed);
+		tail_ = stub;
+	}
+
+	Strand::~Strand(void)
+	{
+		// a drain task holds this strand alive, so nothing can be running here any more
+		while (tail_ != nullptr)
+		{
+			auto next = tail_->next.load(std::memory_order_acquire);
+			delete tail_;
+			tail_ = next;
+		}
+	}
+
+	auto Strand::get_ptr(void) -> std::shared_ptr<Strand> { return shared_from_this(); }
+
+	auto Strand::post(Task task) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (!task)
+		{
+			return { false, "cannot post empty task" };
+		}
+
+		auto node = new Node();
+		node->task = std::move(task);
+		node->next.store(nullptr, std::memory_order_relaxed);
+
+		enqueue(node);
+
+		if (pending_.fetch_add(1, std::memory_order_acq_rel) > 0)
+		{
+			return { true, std::nullopt };
+		}
+
+		auto [scheduled, message] = schedule();
+		if (scheduled)
+		{
+			return { true, std::nullopt };
+		}
+
+		// nobody else will drain this strand, so the backlog is dropped and the next post can schedule it again
+		discard();
+
+		return { false, message };
+	}
+
+	auto Strand::pending(void) const -> size_t { return pending_.load(std::memory_order_relaxed); }
+
+	auto Strand::title(void) const -> const std::string { return title_; }
+
+	auto Strand::enqueue(Node* node) -> void
+	{
+		auto previous = head_.exchange(node, std::memory_order_acq_rel);
+		previous->next.store(node, std::memory_order_release);
+	}
+
+	auto Strand::dequeue(void) -> Node*
+	{
+		auto next = tail_->next.load(std::memory_order_acquire);
+		while (next == nullptr)
+		{
+			// pending_ said a task is there, so a producer is between its exchange and its link
+			std::this_thread::yield();
+			next = tail_->next.load(std::memory_order_acquire);
+		}
+
+		delete tail_;
+		tail_ = next;
+
+		return next;
+	}
+
+	auto Strand::schedule(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		auto pool = pool_.lock();
+		if (pool == nullptr)
+		{
+			return { false, "cannot schedule a strand on null ThreadPool" };
+		}
+
+		auto previous = std::exchange(scheduling_, this);
+		auto result = pool->push(priority_, Task(DrainTask(get_ptr())));
+		scheduling_ = previous;
+
+		return result;
+	}
+
+	auto Strand::drain(void) -> void
+	{
+		size_t drained = 0;
+
+		while (true)
+		{
+			// the node stays as the new stub, so only its task is taken out
+			auto node = dequeue();
+			Task task = std::move(node->task);
+			run(task);
+
+			if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				return;
+			}
+
+			if (++drained < STRAND_DRAIN_LIMIT)
+			{
+				continue;
+			}
+
+			auto [scheduled, message] = schedule();
+			if (scheduled)
+			{
+				return;
+			}
+
+			drained = 0;
+		}
+	}
+
+	auto Strand::discard(void) -> void
+	{
+		size_t discarded = 0;
+
+		do
+		{
+			auto node = dequeue();
+			node->task.reset();
+			++discarded;
+		} while (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1);
+
+		Logger::handle().write(LogTypes::Error, fmt::format("discarded {} tasks on {} without a drain", discarded, title_));
+	}
+
+	auto Strand::run(Task& task) -> void
+	{
+		try
+		{
+			auto [result_condition, error_message] = task();
+			if (!result_condition)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot complete task on {} : {}", title_, error_message.value_or("unknown error")));
+			}
+		}
+		catch (const std::exception& message)
+		{
+			Logger::handle().write(LogTypes::Exception, fmt::format("cannot complete task on {} : {}", title_, message.what()));
+		}
+		catch (...)
+		{
+			Logger::handle().write(LogTypes::Exception, fmt::format("cannot complete task on {} : unexpected error", title_));
+		}
+	}
+} // namespace Thread
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "JobPriorities.h"
+#include "Task.h"
+
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <optional>
+
+namespace Thread
+{
+	class ThreadPool;
+
+	constexpr size_t STRAND_DRAIN_LIMIT = 64;
+
+	// Serial executor on top of a shared ThreadPool.
+	// Tasks posted to one strand run one at a time in FIFO order, while different strands run in parallel on the same workers.
+	// Posting is lock-free: tasks go into an intrusive MPSC queue and only the producer that finds the strand idle pushes a drain task.
+	// A drain runs at most STRAND_DRAIN_LIMIT tasks before it yields its worker back to the pool, so a busy strand cannot starve the others.
+	// When the pool refuses or discards a drain, the backlog queued behind it is discarded and the strand is idle again.
+	class Strand : public std::enable_shared_from_this<Strand>
+	{
+	public:
+		Strand(std::shared_ptr<ThreadPool> pool, const JobPriorities& priority = JobPriorities::Normal, const std::string& title = "Strand");
+		virtual ~Strand(void);
+
+		auto get_ptr(void) -> std::shared_ptr<Strand>;
+
+		auto post(Task task) -> std::tuple<bool, std::optional<std::string>>;
+
+		auto pending(void) const -> size_t;
+		auto title(void) const -> const std::string;
+
+	private:
+		struct Node
+		{
+			Task task;
+			std::atomic<Node*> next;
+		};
+
+		class DrainTask;
+
+		auto enqueue(Node* node) -> void;
+		auto dequeue(void) -> Node*;
+		auto schedule(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto drain(void) -> void;
+		auto discard(void) -> void;
+		auto run(Task& task) -> void;
+
+	private:
+		std::string title_;
+		JobPriorities priority_;
+		std::weak_ptr<ThreadPool> pool_;
+
+		std::atomic<size_t> pending_;
+		std::atomic<Node*> head_;
+		Node* tail_;
+	};
+} // namespace Thread
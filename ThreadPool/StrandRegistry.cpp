@@ -0,0 +1,76 @@
+#include "StrandRegistry.h"
+
+#include "ThreadPool.h"
+
+#include "fmt/format.h"
+#include "fmt/xchar.h"
+
+#include <functional>
+
+namespace Thread
+{
+	StrandRegistry::StrandRegistry(std::shared_ptr<ThreadPool> pool, const JobPriorities& priority) : priority_(priority), pool_(pool) {}
+
+	StrandRegistry::~StrandRegistry(void) {}
+
+	auto StrandRegistry::strand(const std::string& key) -> std::shared_ptr<Strand>
+	{
+		auto& target = shard(key);
+
+		std::scoped_lock<std::mutex> lock(target.mutex);
+
+		auto iter = target.strands.find(key);
+		if (iter != target.strands.end())
+		{
+			return iter->second;
+		}
+
+		auto pool = pool_.lock();
+		if (pool == nullptr)
+		{
+			return nullptr;
+		}
+
+		auto created = std::make_shared<Strand>(pool, priority_, fmt::format("Strand [ {} ]", key));
+		target.strands.insert({ key, created });
+
+		return created;
+	}
+
+	auto StrandRegistry::post(const std::string& key, Task task) -> std::tuple<bool, std::optional<std::string>>
+	{
+		auto target = strand(key);
+		if (target == nullptr)
+		{
+			return { false, "cannot post a task to a strand of null ThreadPool" };
+		}
+
+		return target->post(std::move(task));
+	}
+
+	auto StrandRegistry::erase(const std::string& key) -> bool
+	{
+		auto& target = shard(key);
+
+		std::scoped_lock<std::mutex> lock(target.mutex);
+
+		// queued tasks still run, because every pending drain holds its strand alive
+		return target.strands.erase(key) > 0;
+	}
+
+	auto StrandRegistry::size(void) -> size_t
+	{
+		size_t count = 0;
+
+		for (auto& target : shards_)
+		{
+			std::scoped_lock<std::mutex> lock(target.mutex);
+
+			count += target.strands.size();
+		}
+
+		return count;
+	}
+
+	auto StrandRegistry::shard(const std::string& key) -> Shard& { return shards_[std::hash<std::string>{}(key) % STRAND_SHARD_COUNT]; }
+} // namespace Thread
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "JobPriorities.h"
+#include "Strand.h"
+#include "Task.h"
+
+#include <array>
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <string>
+#include <optional>
+#include <unordered_map>
+
+namespace Thread
+{
+	class ThreadPool;
+
+	constexpr size_t STRAND_SHARD_COUNT = 16;
+
+	// Strands keyed by entity, such as a connection or session id.
+	// A key is looked up under the lock of one of STRAND_SHARD_COUNT shards, never a lock per key;
+	// callers that keep the strand returned by strand() post to it without any lookup at all.
+	// A strand lives until erase() so that a key never gets two strands running side by side.
+	class StrandRegistry
+	{
+	public:
+		StrandRegistry(std::shared_ptr<ThreadPool> pool, const JobPriorities& priority = JobPriorities::Normal);
+		virtual ~StrandRegistry(void);
+
+		auto strand(const std::string& key) -> std::shared_ptr<Strand>;
+		auto post(const std::string& key, Task task) -> std::tuple<bool, std::optional<std::string>>;
+		auto erase(const std::string& key) -> bool;
+		auto size(void) -> size_t;
+
+	private:
+		struct Shard
+		{
+			std::mutex mutex;
+			std::unordered_map<std::string, std::shared_ptr<Strand>> strands;
+		};
+
+		auto shard(const std::string& key) -> Shard&;
+
+	private:
+		JobPriorities priority_;
+		std::weak_ptr<ThreadPool> pool_;
+		std::array<Shard, STRAND_SHARD_COUNT> shards_;
+	};
+} // namespace Thread
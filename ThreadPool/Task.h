@@ -0,0 +1,157 @@
+#pragma once
+
+#include "JobPriorities.h"
+
+#include <new>
+#include <chrono>
+#include <tuple>
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <type_traits>
+
+namespace Thread
+{
+	constexpr size_t TASK_STORAGE_SIZE = 56;
+
+	// Move-only callable with inline storage for small captures.
+	// A Task is pushed into the JobPool by value, so a lambda that fits in TASK_STORAGE_SIZE
+	// is queued and executed without any heap allocation. Larger callables fall back to the heap.
+	// The priority and enqueue time are stamped by JobPool::push and travel with the task for latency accounting.
+	class Task
+	{
+	public:
+		Task(void) : operations_(nullptr), priority_(JobPriorities::Normal) {}
+
+		template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, Task>>>
+		Task(Callable&& callable) : operations_(nullptr), priority_(JobPriorities::Normal)
+		{
+			using Target = std::decay_t<Callable>;
+
+			if constexpr (fits_inline<Target>())
+			{
+				new (storage_) Target(std::forward<Callable>(callable));
+				operations_ = &inline_operations<Target>;
+			}
+			else
+			{
+				*reinterpret_cast<Target**>(storage_) = new Target(std::forward<Callable>(callable));
+				operations_ = &heap_operations<Target>;
+			}
+		}
+
+		Task(Task&& other) noexcept : operations_(nullptr), priority_(JobPriorities::Normal) { move_from(std::move(other)); }
+
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				move_from(std::move(other));
+			}
+
+			return *this;
+		}
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		~Task(void) { reset(); }
+
+		explicit operator bool(void) const { return operations_ != nullptr; }
+
+		auto operator()(void) -> std::tuple<bool, std::optional<std::string>>
+		{
+			if (operations_ == nullptr)
+			{
+				return { false, "cannot run an empty task" };
+			}
+
+			return operations_->invoke(storage_);
+		}
+
+		auto priority(const JobPriorities& priority) -> void { priority_ = priority; }
+		auto priority(void) const -> JobPriorities { return priority_; }
+
+		auto enqueued_time(const std::chrono::steady_clock::time_point& time) -> void { enqueued_time_ = time; }
+		auto enqueued_time(void) const -> std::chrono::steady_clock::time_point { return enqueued_time_; }
+
+		auto reset(void) -> void
+		{
+			if (operations_ == nullptr)
+			{
+				return;
+			}
+
+			operations_->destroy(storage_);
+			operations_ = nullptr;
+		}
+
+	private:
+		struct Operations
+		{
+			std::tuple<bool, std::optional<std::string>> (*invoke)(void*);
+			void (*move)(void*, void*);
+			void (*destroy)(void*);
+		};
+
+		template <typename Target> static constexpr auto fits_inline(void) -> bool
+		{
+			return sizeof(Target) <= TASK_STORAGE_SIZE && alignof(Target) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Target>;
+		}
+
+		template <typename Target> static auto call(Target& target) -> std::tuple<bool, std::optional<std::string>>
+		{
+			if constexpr (std::is_void_v<std::invoke_result_t<Target&>>)
+			{
+				target();
+
+				return { true, std::nullopt };
+			}
+			else
+			{
+				return target();
+			}
+		}
+
+		template <typename Target>
+		static constexpr Operations inline_operations = {
+			[](void* storage) -> std::tuple<bool, std::optional<std::string>> { return call(*static_cast<Target*>(storage)); },
+			[](void* source, void* destination)
+			{
+				new (destination) Target(std::move(*static_cast<Target*>(source)));
+				static_cast<Target*>(source)->~Target();
+			},
+			[](void* storage) { static_cast<Target*>(storage)->~Target(); },
+		};
+
+		template <typename Target>
+		static constexpr Operations heap_operations = {
+			[](void* storage) -> std::tuple<bool, std::optional<std::string>> { return call(**static_cast<Target**>(storage)); },
+			[](void* source, void* destination) { *static_cast<Target**>(destination) = *static_cast<Target**>(source); },
+			[](void* storage) { delete *static_cast<Target**>(storage); },
+		};
+
+		auto move_from(Task&& other) noexcept -> void
+		{
+			priority_ = other.priority_;
+			enqueued_time_ = other.enqueued_time_;
+
+			if (other.operations_ == nullptr)
+			{
+				return;
+			}
+
+			other.operations_->move(other.storage_, storage_);
+			operations_ = other.operations_;
+			other.operations_ = nullptr;
+		}
+
+	private:
+		alignas(std::max_align_t) unsigned char storage_[TASK_STORAGE_SIZE];
+		const Operations* operations_;
+		JobPriorities priority_;
+		std::chrono::steady_clock::time_point enqueued_time_;
+	};
+} // namespace Thread
@@ -1,27 +1,78 @@
 #include "ThreadPool.h"
 
+#include "Job.h"
 #include "JobPool.h"
+#include "LockProfiler.h"
 #include "Logger.h"
 #include "ThreadWorker.h"
+#include "TimerWheel.h"
 
 #include "fmt/chrono.h"
 #include "fmt/format.h"
 #include "fmt/xchar.h"
 
+#include <algorithm>
 #include <functional>
 
 using namespace Utilities;
 
 namespace Thread
 {
+	namespace
+	{
+		// Clears the in-flight flag of a periodic job when its Task goes away, whether it ran or was discarded unrun.
+		class InFlightGuard
+		{
+		public:
+			InFlightGuard(std::shared_ptr<std::atomic_bool> in_flight) : in_flight_(std::move(in_flight)) {}
+
+			InFlightGuard(InFlightGuard&& other) noexcept : in_flight_(std::move(other.in_flight_)) {}
+
+			InFlightGuard(const InFlightGuard&) = delete;
+			InFlightGuard& operator=(const InFlightGuard&) = delete;
+			InFlightGuard& operator=(InFlightGuard&&) = delete;
+
+			~InFlightGuard(void)
+			{
+				if (in_flight_ != nullptr)
+				{
+					in_flight_->store(false);
+				}
+			}
+
+		private:
+			std::shared_ptr<std::atomic_bool> in_flight_;
+		};
+	} // namespace
+
 	ThreadPool::ThreadPool(const std::string& title)
-		: job_pool_(std::make_shared<JobPool>(fmt::format("JobPool on {}", title))), working_(false), thread_title_(title), pause_(false)
+		: pause_(false)
+		, working_(false)
+		, mutex_("ThreadPool::mutex_")
+		, thread_title_(title)
+		, affinity_policy_({ AffinityModes::None, {} })
+		, batch_size_(1)
+		, idle_strategies_()
+		, job_pool_(std::make_shared<JobPool>(fmt::format("JobPool on {}", title)))
+		, idle_registry_(std::make_shared<IdleWorkerRegistry>())
 	{
-		job_pool_->notify_callback(std::bind(&ThreadPool::notify_callback, this, std::placeholders::_1));
+		job_pool_->notify_callback(std::bind(&ThreadPool::notify_callback, this, std::placeholders::_1, std::placeholders::_2));
 	}
 
 	ThreadPool::~ThreadPool(void)
 	{
+#ifdef USE_COROUTINE_MODULE
+		// hops dropped by stop(true) or ~JobPool resume at the end of this destructor, not in the middle of it
+		DeferredResumes deferred;
+#endif
+
+		// the wheel goes first so that no delayed push or autoscaling pass runs against a stopping pool
+		if (timer_wheel_ != nullptr)
+		{
+			timer_wheel_->stop();
+			timer_wheel_.reset();
+		}
+
 		stop(true);
 
 		thread_workers_.clear();
@@ -32,7 +83,7 @@ namespace Thread
 
 	auto ThreadPool::get_ptr(void) -> std::shared_ptr<ThreadPool> { return shared_from_this(); }
 
-	auto ThreadPool::uncompleted_jobs(const std::string& backup_folder) -> std::vector<std::vector<uint8_t>>
+	auto ThreadPool::uncompleted_jobs(const std::string& backup_folder) -> std::vector<UncompletedJob>
 	{
 		if (job_pool_ == nullptr)
 		{
@@ -44,6 +95,16 @@ namespace Thread
 		return job_pool_->uncompleted_jobs(backup_folder);
 	}
 
+	auto ThreadPool::settle(const std::string& backup_folder, const std::vector<uint64_t>& journal_ids) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (job_pool_ == nullptr)
+		{
+			return { false, "cannot settle recovered jobs by null job_pool" };
+		}
+
+		return job_pool_->settle(backup_folder, journal_ids);
+	}
+
 	auto ThreadPool::push(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>
 	{
 		if (job_pool_ == nullptr)
@@ -54,6 +115,30 @@ namespace Thread
 		return job_pool_->push(job);
 	}
 
+	auto ThreadPool::push(const std::vector<std::shared_ptr<Job>>& jobs) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (job_pool_ == nullptr)
+		{
+			return { false, "cannot push jobs into null JobPool" };
+		}
+
+		return job_pool_->push(jobs);
+	}
+
+	auto ThreadPool::push(const JobPriorities& priority, Task task) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (job_pool_ == nullptr)
+		{
+			return { false, "cannot push a task into null JobPool" };
+		}
+
+		return job_pool_->push(priority, std::move(task));
+	}
+
+#ifdef USE_COROUTINE_MODULE
+	auto ThreadPool::schedule(const JobPriorities& priority) -> ScheduleAwaiter { return ScheduleAwaiter(this, priority); }
+#endif
+
 	auto ThreadPool::push(std::shared_ptr<ThreadWorker> worker) -> void
 	{
 		if (worker == nullptr)
@@ -65,11 +150,19 @@ namespace Thread
 
 		auto priority = priority_string(worker->priorities());
 
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		if (affinity_policy_.mode != AffinityModes::None)
+		{
+			worker->affinity(CpuTopology::handle().placement(affinity_policy_, thread_workers_.size()));
+		}
 
 		thread_workers_.push_back(worker);
 
 		worker->job_pool(job_pool_);
+		worker->batch_size(batch_size_);
+		worker->idle_strategy(worker_idle_strategy(worker));
+		worker->idle_registry(idle_registry_);
 		worker->pause(pause_.load());
 		worker->worker_title(fmt::format("{} ThreadWorker on {}", priority, thread_title_));
 
@@ -90,7 +183,7 @@ namespace Thread
 
 		job_pool_->clear(priority);
 
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
 		auto new_end = std::remove_if(thread_workers_.begin(), thread_workers_.end(),
 									  [priority](const std::shared_ptr<ThreadWorker>& worker)
@@ -126,6 +219,275 @@ namespace Thread
 		return { removed_items.size(), std::nullopt };
 	}
 
+	auto ThreadPool::remove_workers(const JobPriorities& priority, const size_t& count) -> std::tuple<size_t, std::optional<std::string>>
+	{
+		std::vector<std::shared_ptr<ThreadWorker>> removed_items;
+
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			// only workers dedicated to this priority are removed, newest first, and the lane keeps its jobs
+			for (auto iter = thread_workers_.rbegin(); iter != thread_workers_.rend() && removed_items.size() < count;)
+			{
+				const auto& worker = *iter;
+				if (worker == nullptr || worker->priorities().size() != 1 || worker->priorities().front() != priority)
+				{
+					++iter;
+					continue;
+				}
+
+				removed_items.push_back(worker);
+				iter = std::make_reverse_iterator(thread_workers_.erase(std::next(iter).base()));
+			}
+		}
+
+		if (removed_items.empty())
+		{
+			return { 0, "no worker to remove" };
+		}
+
+		for (auto& worker : removed_items)
+		{
+			worker->stop();
+		}
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("removed {} {} ThreadWorker on {}", removed_items.size(), priority_string(priority), thread_title_));
+
+		return { removed_items.size(), std::nullopt };
+	}
+
+	auto ThreadPool::autoscale(const JobPriorities& priority, const AutoscalePolicy& policy) -> std::tuple<bool, std::optional<std::string>>
+	{
+		auto autoscaler = std::make_shared<WorkerAutoscaler>(policy);
+
+		auto [valid, invalid_message] = autoscaler->validate();
+		if (!valid)
+		{
+			return { false, invalid_message };
+		}
+
+		auto [wheel, message] = timer_wheel();
+		if (wheel == nullptr)
+		{
+			return { false, message };
+		}
+
+		stop_autoscale(priority);
+
+		// the destructor stops the wheel before anything else, so the callback never outlives this pool
+		auto timer_id = wheel->schedule(policy.interval, policy.interval, [this, priority, autoscaler]() { scale(priority, autoscaler); });
+
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		autoscale_timers_[priority] = timer_id;
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("started autoscaling {} ThreadWorker on {} between {} and {}", priority_string(priority), thread_title_,
+																policy.min_workers, policy.max_workers));
+
+		return { true, std::nullopt };
+	}
+
+	auto ThreadPool::stop_autoscale(const JobPriorities& priority) -> bool
+	{
+		uint64_t timer_id = 0;
+		std::shared_ptr<TimerWheel> wheel = nullptr;
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			auto iter = autoscale_timers_.find(priority);
+			if (iter == autoscale_timers_.end())
+			{
+				return false;
+			}
+
+			timer_id = iter->second;
+			autoscale_timers_.erase(iter);
+
+			wheel = timer_wheel_;
+		}
+
+		if (wheel == nullptr)
+		{
+			return false;
+		}
+
+		return wheel->cancel(timer_id);
+	}
+
+	auto ThreadPool::stop_autoscale(void) -> void
+	{
+		std::map<JobPriorities, uint64_t> timers;
+		std::shared_ptr<TimerWheel> wheel = nullptr;
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			timers.swap(autoscale_timers_);
+			wheel = timer_wheel_;
+		}
+
+		if (wheel == nullptr)
+		{
+			return;
+		}
+
+		for (const auto& [priority, timer_id] : timers)
+		{
+			wheel->cancel(timer_id);
+		}
+	}
+
+	auto ThreadPool::schedule_after(const std::chrono::milliseconds& delay, std::shared_ptr<Job> job) -> std::tuple<uint64_t, std::optional<std::string>>
+	{
+		if (job == nullptr)
+		{
+			return { 0, "cannot schedule a null job" };
+		}
+
+		auto [wheel, message] = timer_wheel();
+		if (wheel == nullptr)
+		{
+			return { 0, message };
+		}
+
+		std::weak_ptr<JobPool> weak_pool = job_pool_;
+		auto title = thread_title_;
+
+		auto timer_id = wheel->schedule(delay, std::chrono::milliseconds(0),
+										[weak_pool, job, title]()
+										{
+											auto pool = weak_pool.lock();
+											if (pool == nullptr)
+											{
+												return;
+											}
+
+											auto [pushed, push_error] = pool->push(job);
+											if (!pushed)
+											{
+												Logger::handle().write(LogTypes::Error, fmt::format("cannot push a delayed job on {} : {}", title, push_error.value_or("unknown")));
+											}
+										});
+
+		return { timer_id, std::nullopt };
+	}
+
+	auto ThreadPool::schedule_every(const std::chrono::milliseconds& period, std::shared_ptr<Job> job) -> std::tuple<uint64_t, std::optional<std::string>>
+	{
+		if (job == nullptr)
+		{
+			return { 0, "cannot schedule a null job" };
+		}
+
+		if (period.count() <= 0)
+		{
+			return { 0, "cannot schedule a job with non-positive period" };
+		}
+
+		auto [wheel, message] = timer_wheel();
+		if (wheel == nullptr)
+		{
+			return { 0, message };
+		}
+
+		job->job_pool(job_pool_);
+
+		// A period that fires while the previous run is still queued or working is skipped,
+		// so one slow job never piles up copies of itself in the lane.
+		auto in_flight = std::make_shared<std::atomic_bool>(false);
+		std::weak_ptr<JobPool> weak_pool = job_pool_;
+		auto title = thread_title_;
+
+		auto timer_id = wheel->schedule(period, period,
+										[weak_pool, job, in_flight, title]()
+										{
+											auto pool = weak_pool.lock();
+											if (pool == nullptr || in_flight->exchange(true))
+											{
+												return;
+											}
+
+											// a rejected Task is destroyed inside push, so the guard clears the flag on every path
+											auto [pushed, push_error]
+												= pool->push(job->priority(), Task([job, guard = InFlightGuard(in_flight)]() { return job->work(); }));
+											if (!pushed)
+											{
+												Logger::handle().write(LogTypes::Error,
+																	   fmt::format("cannot push a periodic job on {} : {}", title, push_error.value_or("unknown")));
+											}
+										});
+
+		return { timer_id, std::nullopt };
+	}
+
+	auto ThreadPool::cancel_timer(const uint64_t& timer_id) -> bool
+	{
+		std::shared_ptr<TimerWheel> wheel = nullptr;
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			wheel = timer_wheel_;
+		}
+
+		if (wheel == nullptr)
+		{
+			return false;
+		}
+
+		return wheel->cancel(timer_id);
+	}
+
+	auto ThreadPool::capacity(const JobPriorities& priority, const CapacityPolicy& policy) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (job_pool_ == nullptr)
+		{
+			return { false, "cannot limit null JobPool" };
+		}
+
+		return job_pool_->capacity(priority, policy);
+	}
+
+	auto ThreadPool::watermark_callback(const std::function<void(const JobPriorities&, const bool&)>& callback) -> void
+	{
+		if (job_pool_ == nullptr)
+		{
+			Logger::handle().write(LogTypes::Error, "cannot set watermark callback on null JobPool");
+
+			return;
+		}
+
+		job_pool_->watermark_callback(callback);
+	}
+
+	auto ThreadPool::journal(const std::string& folder, const size_t& segment_size) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (job_pool_ == nullptr)
+		{
+			return { false, "cannot open a journal on null JobPool" };
+		}
+
+		return job_pool_->journal(folder, segment_size);
+	}
+
+	auto ThreadPool::register_tenant(const std::string& tenant, const size_t& weight) -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (job_pool_ == nullptr)
+		{
+			return { false, "cannot register a tenant on null JobPool" };
+		}
+
+		return job_pool_->register_tenant(tenant, weight);
+	}
+
+	auto ThreadPool::unregister_tenant(const std::string& tenant) -> bool
+	{
+		if (job_pool_ == nullptr)
+		{
+			return false;
+		}
+
+		return job_pool_->unregister_tenant(tenant);
+	}
+
 	auto ThreadPool::lock(const bool& lock_condition) -> void
 	{
 		if (job_pool_ == nullptr)
@@ -150,9 +512,112 @@ namespace Thread
 		return job_pool_->lock();
 	}
 
+	auto ThreadPool::scheduling_mode(const SchedulingModes& mode) -> void
+	{
+		if (job_pool_ == nullptr)
+		{
+			Logger::handle().write(LogTypes::Error, "cannot change scheduling mode of null JobPool");
+
+			return;
+		}
+
+		job_pool_->scheduling_mode(mode);
+	}
+
+	auto ThreadPool::scheduling_mode(void) -> SchedulingModes
+	{
+		if (job_pool_ == nullptr)
+		{
+			Logger::handle().write(LogTypes::Error, "cannot check scheduling mode of null JobPool");
+
+			return SchedulingModes::Shared;
+		}
+
+		return job_pool_->scheduling_mode();
+	}
+
+	auto ThreadPool::affinity(const AffinityPolicy& policy) -> void
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		affinity_policy_ = policy;
+
+		auto& topology = CpuTopology::handle();
+		for (size_t index = 0; index < thread_workers_.size(); ++index)
+		{
+			if (thread_workers_[index] == nullptr)
+			{
+				continue;
+			}
+
+			thread_workers_[index]->affinity(topology.placement(affinity_policy_, index));
+		}
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("changed affinity of {} workers on {} across {} nodes", thread_workers_.size(), thread_title_,
+																topology.node_count()));
+	}
+
+	auto ThreadPool::affinity(void) -> AffinityPolicy
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		return affinity_policy_;
+	}
+
+	auto ThreadPool::batch_size(const size_t& size) -> void
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		batch_size_ = std::max(size, static_cast<size_t>(1));
+
+		for (auto& worker : thread_workers_)
+		{
+			if (worker == nullptr)
+			{
+				continue;
+			}
+
+			worker->batch_size(batch_size_);
+		}
+	}
+
+	auto ThreadPool::batch_size(void) -> size_t
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		return batch_size_;
+	}
+
+	auto ThreadPool::idle_strategy(const JobPriorities& priority, const IdleStrategy& strategy) -> void
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		idle_strategies_[static_cast<size_t>(priority)] = strategy;
+
+		for (auto& worker : thread_workers_)
+		{
+			if (worker == nullptr)
+			{
+				continue;
+			}
+
+			worker->idle_strategy(worker_idle_strategy(worker));
+		}
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("changed idle strategy [ {} ] on {} to {} spins and {} yields", priority_string(priority),
+																thread_title_, strategy.spin_count, strategy.yield_count));
+	}
+
+	auto ThreadPool::idle_strategy(const JobPriorities& priority) -> IdleStrategy
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		return idle_strategies_[static_cast<size_t>(priority)];
+	}
+
 	auto ThreadPool::thread_title(const std::string& title) -> void
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
 		thread_title_ = title;
 
@@ -176,7 +641,7 @@ namespace Thread
 
 	auto ThreadPool::start(void) -> std::tuple<bool, std::optional<std::string>>
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
 		if (working_.load())
 		{
@@ -204,7 +669,7 @@ namespace Thread
 
 	auto ThreadPool::pause(const bool& pause) -> void
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
 		pause_.store(pause);
 
@@ -221,8 +686,16 @@ namespace Thread
 
 	auto ThreadPool::stop(const bool& stop_immediately) -> std::tuple<bool, std::optional<std::string>>
 	{
+#ifdef USE_COROUTINE_MODULE
+		// hops dropped by clear() resume once mutex_ is released, so their coroutines can call back into this pool
+		DeferredResumes deferred;
+#endif
+
+		// a scaling pass would otherwise keep pushing workers into a pool that is going down
+		stop_autoscale();
+
 		{
-			std::scoped_lock<std::mutex> lock(mutex_);
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
 			if (!working_.load())
 			{
@@ -250,30 +723,245 @@ namespace Thread
 				}
 			}
 
+			join_retired_workers(false);
+
 			job_pool_->lock(false);
 		}
 
 		working_.store(false);
 
+		write_lock_statistics();
+
+		return { true, std::nullopt };
+	}
+
+	auto ThreadPool::stop(const std::chrono::steady_clock::time_point& drain_until, const std::string& backup_folder)
+		-> std::tuple<bool, std::optional<std::string>>
+	{
+#ifdef USE_COROUTINE_MODULE
+		DeferredResumes deferred;
+#endif
+
+		stop_autoscale();
+
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			if (!working_.load())
+			{
+				return { false, "not started" };
+			}
+
+			job_pool_->lock(true);
+
+			// every worker is told before any join, so they drain side by side instead of one after another
+			for (auto& worker : thread_workers_)
+			{
+				if (worker == nullptr)
+				{
+					continue;
+				}
+
+				worker->drain(drain_until);
+			}
+
+			for (auto& worker : thread_workers_)
+			{
+				if (worker == nullptr)
+				{
+					continue;
+				}
+
+				auto [stopped, stop_error] = worker->stop();
+				if (!stopped)
+				{
+					return { false, stop_error };
+				}
+			}
+
+			auto [persisted, persist_error] = job_pool_->persist(backup_folder);
+			if (persist_error.has_value())
+			{
+				Logger::handle().write(LogTypes::Error, persist_error.value());
+			}
+
+			Logger::handle().write(LogTypes::Information, fmt::format("drained {} and persisted {} remaining jobs", thread_title_, persisted));
+
+			join_retired_workers(false);
+
+			job_pool_->lock(false);
+		}
+
+		working_.store(false);
+
+		write_lock_statistics();
+
 		return { true, std::nullopt };
 	}
 
 	auto ThreadPool::job_pool(void) -> std::shared_ptr<JobPool> { return job_pool_; }
 
-	auto ThreadPool::notify_callback(const JobPriorities& priority) -> void
+	auto ThreadPool::worker_count(const JobPriorities& priority) -> size_t
 	{
-		Logger::handle().write(LogTypes::Sequence, fmt::format("notify one for {} priority", priority_string(priority)));
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
-		std::scoped_lock<std::mutex> lock(mutex_);
+		return std::count_if(thread_workers_.begin(), thread_workers_.end(),
+							 [priority](const std::shared_ptr<ThreadWorker>& worker)
+							 {
+								 if (worker == nullptr)
+								 {
+									 return false;
+								 }
 
-		for (auto& worker : thread_workers_)
+								 const auto& priorities = worker->priorities();
+
+								 return std::find(priorities.begin(), priorities.end(), priority) != priorities.end();
+							 });
+	}
+
+	auto ThreadPool::wakeup_counters(void) -> WakeupCounters { return idle_registry_->counters(); }
+
+	auto ThreadPool::metrics(void) -> std::vector<PriorityMetrics>
+	{
+		if (job_pool_ == nullptr)
 		{
-			if (worker == nullptr)
+			Logger::handle().write(LogTypes::Error, "cannot take metrics of null JobPool");
+
+			return {};
+		}
+
+		return job_pool_->metrics()->snapshot();
+	}
+
+	auto ThreadPool::worker_idle_strategy(std::shared_ptr<ThreadWorker> worker) -> IdleStrategy
+	{
+		// a worker serving several lanes follows its most urgent one, so a spinning High lane is not parked by a shared Low lane
+		auto priorities = worker->priorities();
+		if (priorities.empty())
+		{
+			return { 0, 0 };
+		}
+
+		return idle_strategies_[static_cast<size_t>(*std::min_element(priorities.begin(), priorities.end()))];
+	}
+
+	auto ThreadPool::write_lock_statistics(void) -> void
+	{
+		// counters are shared by every lock of the same name in the process, so they are not attributed to this pool
+		for (const auto& statistics : LockProfiler::handle().snapshot())
+		{
+			Logger::handle().write(LogTypes::Information,
+								   fmt::format("{} : {} acquisitions, {} contended, wait p50 {} p99 {} max {}, hold p50 {} p99 {} max {}", statistics.name,
+											   statistics.acquisitions, statistics.contended, statistics.wait.p50, statistics.wait.p99, statistics.wait.max,
+											   statistics.hold.p50, statistics.hold.p99, statistics.hold.max));
+		}
+	}
+
+	auto ThreadPool::notify_callback(const JobPriorities& priority, const size_t& count) -> void
+	{
+		auto notified = idle_registry_->notify(priority, count);
+
+		Logger::handle().write(LogTypes::Sequence, fmt::format("notified {} of {} for {} priority", notified, count, priority_string(priority)));
+	}
+
+	auto ThreadPool::timer_wheel(void) -> std::tuple<std::shared_ptr<TimerWheel>, std::optional<std::string>>
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		if (timer_wheel_ != nullptr)
+		{
+			return { timer_wheel_, std::nullopt };
+		}
+
+		auto wheel = std::make_shared<TimerWheel>(std::chrono::milliseconds(1), fmt::format("TimerWheel on {}", thread_title_));
+
+		auto [started, start_error] = wheel->start();
+		if (!started)
+		{
+			return { nullptr, start_error };
+		}
+
+		timer_wheel_ = wheel;
+
+		return { timer_wheel_, std::nullopt };
+	}
+
+	auto ThreadPool::scale(const JobPriorities& priority, std::shared_ptr<WorkerAutoscaler> autoscaler) -> void
+	{
+		if (job_pool_ == nullptr || autoscaler == nullptr || job_pool_->lock())
+		{
+			return;
+		}
+
+		auto workers = worker_count(priority);
+		auto target = autoscaler->evaluate(workers, job_pool_->job_count(priority), job_pool_->consumed_count(priority));
+		if (target == workers)
+		{
+			return;
+		}
+
+		if (target < workers)
+		{
+			retire_workers(priority, workers - target);
+
+			return;
+		}
+
+		for (size_t index = workers; index < target; ++index)
+		{
+			push(std::make_shared<ThreadWorker>(std::vector<JobPriorities>{ priority }));
+		}
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("scaled {} ThreadWorker on {} from {} to {}", priority_string(priority), thread_title_, workers, target));
+	}
+
+	auto ThreadPool::retire_workers(const JobPriorities& priority, const size_t& count) -> size_t
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		join_retired_workers(true);
+
+		// this runs on the timer wheel, so a worker in the middle of a long job is told to finish it and joined later instead of here
+		size_t retired = 0;
+		auto now = std::chrono::steady_clock::now();
+		for (auto iter = thread_workers_.rbegin(); iter != thread_workers_.rend() && retired < count;)
+		{
+			const auto& worker = *iter;
+			if (worker == nullptr || worker->priorities().size() != 1 || worker->priorities().front() != priority)
 			{
+				++iter;
 				continue;
 			}
 
-			worker->notify_one(priority);
+			worker->drain(now);
+			retired_workers_.push_back(worker);
+			++retired;
+
+			iter = std::make_reverse_iterator(thread_workers_.erase(std::next(iter).base()));
+		}
+
+		if (retired > 0)
+		{
+			Logger::handle().write(LogTypes::Parameter, fmt::format("retired {} {} ThreadWorker on {}", retired, priority_string(priority), thread_title_));
 		}
+
+		return retired;
+	}
+
+	auto ThreadPool::join_retired_workers(const bool& finished_only) -> void
+	{
+		auto new_end = std::remove_if(retired_workers_.begin(), retired_workers_.end(),
+									  [finished_only](const std::shared_ptr<ThreadWorker>& worker)
+									  {
+										  if (finished_only && worker->running())
+										  {
+											  return false;
+										  }
+
+										  worker->stop();
+
+										  return true;
+									  });
+		retired_workers_.erase(new_end, retired_workers_.end());
 	}
 } // namespace Thread
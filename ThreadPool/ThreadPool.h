@@ -1,9 +1,27 @@
 #pragma once
 
 #include "JobPriorities.h"
+#include "InstrumentedMutex.h"
+#include "SchedulingModes.h"
+#include "Task.h"
+#include "Future.h"
+#include "IdleWorkerRegistry.h"
+#include "WorkerAutoscaler.h"
+#include "CpuTopology.h"
+#include "JobMetrics.h"
+#include "JobJournal.h"
+#include "ThreadWorker.h"
 
+#ifdef USE_COROUTINE_MODULE
+#include "Coroutine.h"
+#endif
+
+#include <map>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -13,7 +31,8 @@ namespace Thread
 {
 	class Job;
 	class JobPool;
-	class ThreadWorker;
+	struct CapacityPolicy;
+	class TimerWheel;
 	class ThreadPool : public std::enable_shared_from_this<ThreadPool>
 	{
 	public:
@@ -22,32 +41,126 @@ namespace Thread
 
 		auto get_ptr(void) -> std::shared_ptr<ThreadPool>;
 
-		auto uncompleted_jobs(const std::string& backup_folder) -> std::vector<std::vector<uint8_t>>;
+		auto uncompleted_jobs(const std::string& backup_folder) -> std::vector<UncompletedJob>;
+		auto settle(const std::string& backup_folder, const std::vector<uint64_t>& journal_ids) -> std::tuple<bool, std::optional<std::string>>;
 		auto push(std::shared_ptr<Job> job) -> std::tuple<bool, std::optional<std::string>>;
+		auto push(const std::vector<std::shared_ptr<Job>>& jobs) -> std::tuple<bool, std::optional<std::string>>;
+		auto push(const JobPriorities& priority, Task task) -> std::tuple<bool, std::optional<std::string>>;
 		auto push(std::shared_ptr<ThreadWorker> worker) -> void;
+
+		template <typename Callable>
+		auto submit(const JobPriorities& priority, Callable&& callable) -> Future<std::invoke_result_t<std::decay_t<Callable>&>>;
+
+#ifdef USE_COROUTINE_MODULE
+		auto schedule(const JobPriorities& priority) -> ScheduleAwaiter;
+#endif
 		auto remove_workers(const JobPriorities& priority) -> std::tuple<size_t, std::optional<std::string>>;
+		auto remove_workers(const JobPriorities& priority, const size_t& count) -> std::tuple<size_t, std::optional<std::string>>;
+
+		auto autoscale(const JobPriorities& priority, const AutoscalePolicy& policy) -> std::tuple<bool, std::optional<std::string>>;
+		auto stop_autoscale(const JobPriorities& priority) -> bool;
+		auto stop_autoscale(void) -> void;
+
+		auto schedule_after(const std::chrono::milliseconds& delay, std::shared_ptr<Job> job) -> std::tuple<uint64_t, std::optional<std::string>>;
+		auto schedule_every(const std::chrono::milliseconds& period, std::shared_ptr<Job> job) -> std::tuple<uint64_t, std::optional<std::string>>;
+		auto cancel_timer(const uint64_t& timer_id) -> bool;
+
+		auto capacity(const JobPriorities& priority, const CapacityPolicy& policy) -> std::tuple<bool, std::optional<std::string>>;
+		auto watermark_callback(const std::function<void(const JobPriorities&, const bool&)>& callback) -> void;
+
+		auto journal(const std::string& folder, const size_t& segment_size = JOURNAL_SEGMENT_SIZE) -> std::tuple<bool, std::optional<std::string>>;
+
+		auto register_tenant(const std::string& tenant, const size_t& weight = 1) -> std::tuple<bool, std::optional<std::string>>;
+		auto unregister_tenant(const std::string& tenant) -> bool;
 
 		auto lock(const bool& lock_condition) -> void;
 		auto lock(void) -> bool;
 
+		auto scheduling_mode(const SchedulingModes& mode) -> void;
+		auto scheduling_mode(void) -> SchedulingModes;
+
+		auto affinity(const AffinityPolicy& policy) -> void;
+		auto affinity(void) -> AffinityPolicy;
+
+		auto batch_size(const size_t& size) -> void;
+		auto batch_size(void) -> size_t;
+
+		auto idle_strategy(const JobPriorities& priority, const IdleStrategy& strategy) -> void;
+		auto idle_strategy(const JobPriorities& priority) -> IdleStrategy;
+
 		auto thread_title(const std::string& title) -> void;
 		auto thread_title(void) -> const std::string;
 
 		auto start(void) -> std::tuple<bool, std::optional<std::string>>;
 		auto pause(const bool& pause) -> void;
 		auto stop(const bool& stop_immediately = false) -> std::tuple<bool, std::optional<std::string>>;
+		auto stop(const std::chrono::steady_clock::time_point& drain_until, const std::string& backup_folder) -> std::tuple<bool, std::optional<std::string>>;
 
 		auto job_pool(void) -> std::shared_ptr<JobPool>;
+		auto worker_count(const JobPriorities& priority) -> size_t;
+		auto wakeup_counters(void) -> WakeupCounters;
+		auto metrics(void) -> std::vector<PriorityMetrics>;
 
 	protected:
-		auto notify_callback(const JobPriorities& priority) -> void;
+		auto notify_callback(const JobPriorities& priority, const size_t& count) -> void;
+		auto timer_wheel(void) -> std::tuple<std::shared_ptr<TimerWheel>, std::optional<std::string>>;
+		auto scale(const JobPriorities& priority, std::shared_ptr<WorkerAutoscaler> autoscaler) -> void;
+		auto retire_workers(const JobPriorities& priority, const size_t& count) -> size_t;
+		auto join_retired_workers(const bool& finished_only) -> void;
+		auto worker_idle_strategy(std::shared_ptr<ThreadWorker> worker) -> IdleStrategy;
+		auto write_lock_statistics(void) -> void;
 
 	private:
 		std::atomic_bool pause_;
 		std::atomic_bool working_;
-		std::mutex mutex_;
+		InstrumentedMutex mutex_;
 		std::string thread_title_;
+		AffinityPolicy affinity_policy_;
+		size_t batch_size_;
+		std::array<IdleStrategy, JOB_PRIORITY_COUNT> idle_strategies_;
 		std::shared_ptr<JobPool> job_pool_;
+		std::shared_ptr<IdleWorkerRegistry> idle_registry_;
+		std::shared_ptr<TimerWheel> timer_wheel_;
 		std::vector<std::shared_ptr<ThreadWorker>> thread_workers_;
+		std::vector<std::shared_ptr<ThreadWorker>> retired_workers_;
+		std::map<JobPriorities, uint64_t> autoscale_timers_;
 	};
+
+	template <typename Callable>
+	auto ThreadPool::submit(const JobPriorities& priority, Callable&& callable) -> Future<std::invoke_result_t<std::decay_t<Callable>&>>
+	{
+		using Result = std::invoke_result_t<std::decay_t<Callable>&>;
+
+		Promise<Result> promise;
+		auto future = promise.get_future();
+
+		Task task(
+			[promise = std::move(promise), target = std::forward<Callable>(callable)]() mutable
+			{
+				try
+				{
+					if constexpr (std::is_void_v<Result>)
+					{
+						target();
+						promise.set_value();
+					}
+					else
+					{
+						promise.set_value(target());
+					}
+				}
+				catch (...)
+				{
+					promise.set_exception(std::current_exception());
+				}
+			});
+
+		auto [pushed, message] = push(priority, std::move(task));
+		if (!pushed)
+		{
+			return Future<Result>::exceptional(std::make_exception_ptr(std::runtime_error(message.value_or("cannot submit a task"))));
+		}
+
+		return future;
+	}
 } // namespace Thread
\ No newline at end of file
@@ -1,20 +1,59 @@
 #include "ThreadWorker.h"
 
 #include "Converter.h"
+#include "CpuTopology.h"
+#include "IdleWorkerRegistry.h"
 #include "Job.h"
+#include "JobMetrics.h"
 #include "JobPool.h"
 #include "Logger.h"
+#include "WorkerQueue.h"
 
 #include "fmt/chrono.h"
 #include "fmt/format.h"
 #include "fmt/xchar.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 using namespace Utilities;
 
 namespace Thread
 {
+	namespace
+	{
+		inline auto cpu_relax(void) -> void
+		{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_pause();
+#elif defined(_MSC_VER)
+			__yield();
+#elif defined(__x86_64__) || defined(__i386__)
+			_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			asm volatile("yield" ::: "memory");
+#endif
+		}
+	} // namespace
+
 	ThreadWorker::ThreadWorker(const std::vector<JobPriorities>& priorities, const std::string& worker_title)
-		: thread_(nullptr), priorities_(priorities), thread_worker_title_(worker_title), pause_(false), thread_stop_(false)
+		: mutex_("ThreadWorker::mutex_")
+		, parked_(false)
+		, pause_(false)
+		, thread_stop_(false)
+		, running_(false)
+		, affinity_changed_(false)
+		, batch_size_(1)
+		, spin_count_(0)
+		, yield_count_(0)
+		, drain_until_(std::chrono::steady_clock::time_point::max().time_since_epoch().count())
+		, thread_worker_title_(worker_title)
+		, thread_(nullptr)
+		, priorities_(priorities)
+		, worker_queue_(std::make_shared<WorkerQueue>(priorities))
 	{
 	}
 
@@ -34,6 +73,7 @@ namespace Thread
 		}
 
 		thread_stop_.store(false);
+		running_.store(true);
 
 		std::future<bool> future = promise_.get_future();
 
@@ -43,6 +83,8 @@ namespace Thread
 		}
 		catch (const std::bad_alloc& e)
 		{
+			running_.store(false);
+
 			return { false, "Failed to create thread instance." };
 		}
 
@@ -54,31 +96,33 @@ namespace Thread
 
 	auto ThreadWorker::pause(const bool& pause) -> void
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 		pause_.store(pause);
 		condition_.notify_one();
 	}
 
-	auto ThreadWorker::notify_one(const JobPriorities& target) -> void
+	auto ThreadWorker::notify_one(const JobPriorities& target) -> bool
 	{
 		if (thread_ == nullptr)
 		{
-			return;
+			return false;
 		}
 
 		if (priorities_.empty())
 		{
-			return;
+			return false;
 		}
 
 		auto iter = std::find(priorities_.begin(), priorities_.end(), target);
 		if (iter == priorities_.end())
 		{
-			return;
+			return false;
 		}
 
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 		condition_.notify_one();
+
+		return true;
 	}
 
 	auto ThreadWorker::stop(void) -> std::tuple<bool, std::optional<std::string>>
@@ -93,7 +137,7 @@ namespace Thread
 			Logger::handle().write(LogTypes::Sequence, fmt::format("attempt to join for {} to stop", thread_worker_title_));
 
 			{
-				std::scoped_lock<std::mutex> lock(mutex_);
+				std::scoped_lock<InstrumentedMutex> lock(mutex_);
 
 				thread_stop_.store(true);
 				condition_.notify_one();
@@ -107,8 +151,46 @@ namespace Thread
 		return { true, std::nullopt };
 	}
 
+	auto ThreadWorker::drain(const std::chrono::steady_clock::time_point& drain_until) -> void
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		drain_until_.store(drain_until.time_since_epoch().count());
+		thread_stop_.store(true);
+		condition_.notify_one();
+	}
+
+	auto ThreadWorker::running(void) -> bool { return running_.load(); }
+
 	auto ThreadWorker::job_pool(std::shared_ptr<JobPool> pool) -> void { job_pool_ = pool; }
 
+	auto ThreadWorker::idle_registry(std::shared_ptr<IdleWorkerRegistry> registry) -> void
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		idle_registry_ = registry;
+	}
+
+	auto ThreadWorker::affinity(const std::vector<size_t>& cores) -> void
+	{
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+		cores_ = cores;
+		affinity_changed_.store(true);
+	}
+
+	auto ThreadWorker::batch_size(const size_t& size) -> void { batch_size_.store(std::max(size, static_cast<size_t>(1))); }
+
+	auto ThreadWorker::batch_size(void) -> size_t { return batch_size_.load(); }
+
+	auto ThreadWorker::idle_strategy(const IdleStrategy& strategy) -> void
+	{
+		spin_count_.store(strategy.spin_count);
+		yield_count_.store(strategy.yield_count);
+	}
+
+	auto ThreadWorker::idle_strategy(void) -> IdleStrategy { return { spin_count_.load(), yield_count_.load() }; }
+
 	auto ThreadWorker::worker_title(const std::string& title) -> void { thread_worker_title_ = title; }
 
 	auto ThreadWorker::worker_title(void) -> std::string { return thread_worker_title_; }
@@ -117,8 +199,9 @@ namespace Thread
 
 	auto ThreadWorker::priorities(const std::vector<JobPriorities>& priorities) -> void
 	{
-		std::scoped_lock<std::mutex> lock(mutex_);
+		std::scoped_lock<InstrumentedMutex> lock(mutex_);
 		priorities_ = priorities;
+		worker_queue_->priorities(priorities);
 	}
 
 	auto ThreadWorker::run(void) -> void
@@ -126,10 +209,23 @@ namespace Thread
 		Logger::handle().write(LogTypes::Sequence, fmt::format("started thread for {}", thread_worker_title_));
 		promise_.set_value(true);
 
+		{
+			std::scoped_lock<InstrumentedMutex> lock(mutex_);
+
+			apply_affinity();
+		}
+
+		std::weak_ptr<JobPool> attached_pool = job_pool_;
+		if (auto target_pool = attached_pool.lock(); target_pool != nullptr)
+		{
+			target_pool->attach(worker_queue_);
+		}
+
 		while (true)
 		{
 			Logger::handle().write(LogTypes::Parameter, fmt::format("attempt to wait condition_variable for {}", thread_worker_title_));
-			std::unique_lock<std::mutex> unique(mutex_);
+			InstrumentedLock unique(mutex_);
+			spin(unique);
 			condition_.wait(unique,
 							[this]()
 							{
@@ -139,7 +235,9 @@ namespace Thread
 							});
 			Logger::handle().write(LogTypes::Parameter, fmt::format("notified condition_variable for {}", thread_worker_title_));
 
-			if (thread_stop_.load() && !has_job())
+			apply_affinity();
+
+			if (thread_stop_.load() && (!has_job() || drain_expired()))
 			{
 				break;
 			}
@@ -157,10 +255,49 @@ namespace Thread
 				break;
 			}
 
+			auto batch_size = batch_size_.load(std::memory_order_relaxed);
+			if (batch_size > 1)
+			{
+				auto claimed = job_pool->pop(priorities_, batch_size, batch_jobs_, batch_tasks_);
+				unique.unlock();
+
+				if (idle_registry_ != nullptr)
+				{
+					idle_registry_->record_pop(claimed > 0);
+				}
+
+				if (claimed == 0 && thread_stop_.load())
+				{
+					break;
+				}
+
+				run_batch(job_pool);
+
+				continue;
+			}
+
 			Logger::handle().write(LogTypes::Sequence, fmt::format("attempt to pop job for {}", thread_worker_title_));
 
-			auto current_job = job_pool->pop(priorities_);
+			Task current_task;
+			auto current_job = job_pool->pop(priorities_, current_task);
 			unique.unlock();
+
+			auto started_time = std::chrono::steady_clock::now();
+			auto metrics = job_pool->metrics();
+
+			if (idle_registry_ != nullptr)
+			{
+				idle_registry_->record_pop(current_job != nullptr || current_task);
+			}
+
+			if (current_task)
+			{
+				auto succeeded = do_run(current_task);
+				metrics->record_completion(current_task.priority(), current_task.enqueued_time(), started_time, succeeded);
+
+				continue;
+			}
+
 			if (current_job == nullptr)
 			{
 				if (thread_stop_.load())
@@ -173,16 +310,60 @@ namespace Thread
 				continue;
 			}
 
-			if (do_run(current_job))
+			auto succeeded = run_job(job_pool, current_job, started_time);
+			if (succeeded)
 			{
 				Logger::handle().write(LogTypes::Sequence, fmt::format("completed work {} [ {} ] on {}", current_job->title(), priority_string(current_job->priority()),
 																	   thread_worker_title_));
 			}
 		}
 
+		if (auto target_pool = attached_pool.lock(); target_pool != nullptr)
+		{
+			target_pool->detach(worker_queue_);
+		}
+
+		if (parked_)
+		{
+			unpark();
+		}
+
 		thread_stop_.store(false);
+		drain_until_.store(std::chrono::steady_clock::time_point::max().time_since_epoch().count());
 
 		Logger::handle().write(LogTypes::Sequence, fmt::format("stopped thread for {}", thread_worker_title_));
+
+		running_.store(false);
+	}
+
+	auto ThreadWorker::run_job(std::shared_ptr<JobPool> job_pool, std::shared_ptr<Job> job, const std::chrono::steady_clock::time_point& started_time) -> bool
+	{
+		auto metrics = job_pool->metrics();
+
+		if (job->cancelled())
+		{
+			job->destroy();
+			job_pool->complete(job);
+			metrics->record_cancelled(job->priority());
+
+			return false;
+		}
+
+		auto succeeded = do_run(job);
+
+		// a cancel that lands while the job runs makes work() return false, which is not a failure of the job
+		if (!succeeded && job->cancelled())
+		{
+			metrics->record_cancelled(job->priority());
+		}
+		else
+		{
+			metrics->record_completion(job->priority(), job->enqueued_time(), started_time, succeeded);
+		}
+
+		job_pool->complete(job);
+
+		return succeeded;
 	}
 
 	auto ThreadWorker::do_run(std::shared_ptr<Job> job) -> bool
@@ -190,6 +371,13 @@ namespace Thread
 		try
 		{
 			auto [result_condition, error_message] = job->work();
+			if (!result_condition && job->cancelled())
+			{
+				Logger::handle().write(LogTypes::Sequence, fmt::format("cancelled {} [ {} ] on {}", job->title(), priority_string(job->priority()), thread_worker_title_));
+
+				return false;
+			}
+
 			if (!result_condition)
 			{
 				Logger::handle().write(LogTypes::Error, fmt::format("cannot complete {} [ {} ] on {} : {},\n{}", job->title(), priority_string(job->priority()),
@@ -230,6 +418,90 @@ namespace Thread
 		}
 	}
 
+	auto ThreadWorker::do_run(Task& task) -> bool
+	{
+		try
+		{
+			auto [result_condition, error_message] = task();
+			if (!result_condition)
+			{
+				Logger::handle().write(LogTypes::Error, fmt::format("cannot complete task on {} : {}", thread_worker_title_, error_message.value_or("unknown error")));
+
+				return false;
+			}
+
+			return true;
+		}
+		catch (const std::exception& message)
+		{
+			Logger::handle().write(LogTypes::Exception, fmt::format("cannot complete task on {} : {}", thread_worker_title_, message.what()));
+
+			return false;
+		}
+		catch (...)
+		{
+			Logger::handle().write(LogTypes::Exception, fmt::format("cannot complete task on {} : unexpected error", thread_worker_title_));
+
+			return false;
+		}
+	}
+
+	auto ThreadWorker::run_batch(std::shared_ptr<JobPool> job_pool) -> void
+	{
+		auto metrics = job_pool->metrics();
+
+		// the whole batch runs even if the worker is paused or stopped meanwhile, because nobody else can see claimed jobs any more
+		for (auto& task : batch_tasks_)
+		{
+			auto started_time = std::chrono::steady_clock::now();
+			auto succeeded = do_run(task);
+			metrics->record_completion(task.priority(), task.enqueued_time(), started_time, succeeded);
+		}
+
+		// a job claimed by this batch may be cancelled while earlier ones are still running
+		for (auto& job : batch_jobs_)
+		{
+			run_job(job_pool, job, std::chrono::steady_clock::now());
+		}
+
+		if (!batch_jobs_.empty() || !batch_tasks_.empty())
+		{
+			Logger::handle().write(LogTypes::Sequence,
+								   fmt::format("completed {} jobs and {} tasks on {}", batch_jobs_.size(), batch_tasks_.size(), thread_worker_title_));
+		}
+
+		batch_tasks_.clear();
+		batch_jobs_.clear();
+	}
+
+	auto ThreadWorker::spin(InstrumentedLock& unique) -> void
+	{
+		auto spin_count = spin_count_.load(std::memory_order_relaxed);
+		auto total_count = spin_count + yield_count_.load(std::memory_order_relaxed);
+
+		// the mutex is released between rounds so that pause, stop and notify_one never wait behind a spinning worker
+		for (size_t count = 0; count < total_count; ++count)
+		{
+			if (thread_stop_.load() || pause_.load() || has_job())
+			{
+				return;
+			}
+
+			unique.unlock();
+
+			if (count < spin_count)
+			{
+				cpu_relax();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+
+			unique.lock();
+		}
+	}
+
 	auto ThreadWorker::check_condition(void) -> bool
 	{
 		if (thread_stop_.load())
@@ -238,11 +510,90 @@ namespace Thread
 		}
 
 		if (pause_.load())
+		{
+			if (parked_)
+			{
+				unpark();
+			}
+
+			return false;
+		}
+
+		if (has_job())
+		{
+			if (parked_)
+			{
+				unpark();
+			}
+
+			return true;
+		}
+
+		if (idle_registry_ == nullptr)
+		{
+			return false;
+		}
+
+		idle_registry_->park(get_ptr(), priorities_);
+		parked_ = true;
+
+		if (!has_job())
 		{
 			return false;
 		}
 
-		return has_job();
+		unpark();
+
+		return true;
+	}
+
+	auto ThreadWorker::unpark(void) -> void
+	{
+		parked_ = false;
+
+		if (idle_registry_ == nullptr)
+		{
+			return;
+		}
+
+		idle_registry_->unpark(get_ptr());
+	}
+
+	auto ThreadWorker::apply_affinity(void) -> void
+	{
+		if (!affinity_changed_.load(std::memory_order_relaxed) || !affinity_changed_.exchange(false))
+		{
+			return;
+		}
+
+		auto& topology = CpuTopology::handle();
+
+		// empty cores release a previous pin back to the whole machine
+		auto cores = cores_;
+		if (cores.empty())
+		{
+			for (size_t node = 0; node < topology.node_count(); ++node)
+			{
+				auto node_cores = topology.cores(node);
+				cores.insert(cores.end(), node_cores.begin(), node_cores.end());
+			}
+		}
+
+		auto [pinned, pin_error] = CpuTopology::pin(cores);
+		if (!pinned)
+		{
+			Logger::handle().write(LogTypes::Error, fmt::format("cannot pin {} : {}", thread_worker_title_, pin_error.value_or("unknown error")));
+
+			return;
+		}
+
+		Logger::handle().write(LogTypes::Parameter, fmt::format("pinned {} to {} cores", thread_worker_title_, cores.size()));
+	}
+
+	auto ThreadWorker::drain_expired(void) -> bool
+	{
+		// whatever is still queued after the deadline is left in the pool for the caller to persist
+		return std::chrono::steady_clock::now().time_since_epoch().count() >= drain_until_.load();
 	}
 
 	auto ThreadWorker::has_job(void) -> bool
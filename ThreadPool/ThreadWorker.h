@@ -1,14 +1,18 @@
 #pragma once
 
 #include "JobPriorities.h"
+#include "InstrumentedMutex.h"
+#include "Task.h"
 
 #include <tuple>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <thread>
 #include <vector>
 #include <future>
+#include <mutex>
 #include <optional>
 #include <condition_variable>
 
@@ -16,6 +20,19 @@ namespace Thread
 {
 	class Job;
 	class JobPool;
+	class WorkerQueue;
+	class IdleWorkerRegistry;
+	class JobMetrics;
+
+	// How long an idle worker keeps polling its lanes before it parks on the condition variable.
+	// spin_count rounds with a CPU pause hint come first, then yield_count rounds of std::this_thread::yield.
+	// The default of zero for both parks immediately, which suits lanes where a futex wake-up costs less than a busy core.
+	struct IdleStrategy
+	{
+		size_t spin_count;
+		size_t yield_count;
+	};
+
 	class ThreadWorker : public std::enable_shared_from_this<ThreadWorker>
 	{
 	public:
@@ -26,10 +43,20 @@ namespace Thread
 
 		auto start(void) -> std::tuple<bool, std::optional<std::string>>;
 		auto pause(const bool& pause) -> void;
-		auto notify_one(const JobPriorities& target) -> void;
+		auto notify_one(const JobPriorities& target) -> bool;
 		auto stop(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto drain(const std::chrono::steady_clock::time_point& drain_until) -> void;
+		auto running(void) -> bool;
 
 		auto job_pool(std::shared_ptr<JobPool> pool) -> void;
+		auto idle_registry(std::shared_ptr<IdleWorkerRegistry> registry) -> void;
+		auto affinity(const std::vector<size_t>& cores) -> void;
+
+		auto batch_size(const size_t& size) -> void;
+		auto batch_size(void) -> size_t;
+
+		auto idle_strategy(const IdleStrategy& strategy) -> void;
+		auto idle_strategy(void) -> IdleStrategy;
 
 		auto worker_title(const std::string& title) -> void;
 		auto worker_title(void) -> std::string;
@@ -39,23 +66,42 @@ namespace Thread
 
 	private:
 		auto run(void) -> void;
+		auto run_job(std::shared_ptr<JobPool> job_pool, std::shared_ptr<Job> job, const std::chrono::steady_clock::time_point& started_time) -> bool;
 		auto do_run(std::shared_ptr<Job> job) -> bool;
+		auto do_run(Task& task) -> bool;
+		auto run_batch(std::shared_ptr<JobPool> job_pool) -> void;
+		auto spin(InstrumentedLock& unique) -> void;
 		auto check_condition(void) -> bool;
+		auto drain_expired(void) -> bool;
+		auto unpark(void) -> void;
+		auto apply_affinity(void) -> void;
 
 		auto has_job(void) -> bool;
 
 	private:
-		std::mutex mutex_;
+		InstrumentedMutex mutex_;
 
+		bool parked_;
 		std::atomic_bool pause_;
 		std::atomic_bool thread_stop_;
+		std::atomic_bool running_;
+		std::atomic_bool affinity_changed_;
+		std::atomic<size_t> batch_size_;
+		std::atomic<size_t> spin_count_;
+		std::atomic<size_t> yield_count_;
+		std::atomic<std::chrono::steady_clock::rep> drain_until_;
 
 		std::promise<bool> promise_;
 
 		std::weak_ptr<JobPool> job_pool_;
 		std::string thread_worker_title_;
-		std::condition_variable condition_;
+		InstrumentedCondition condition_;
 		std::unique_ptr<std::thread> thread_;
 		std::vector<JobPriorities> priorities_;
+		std::vector<size_t> cores_;
+		std::vector<Task> batch_tasks_;
+		std::vector<std::shared_ptr<Job>> batch_jobs_;
+		std::shared_ptr<WorkerQueue> worker_queue_;
+		std::shared_ptr<IdleWorkerRegistry> idle_registry_;
 	};
 } // namespace Thread
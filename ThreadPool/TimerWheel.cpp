@@ -0,0 +1,280 @@
+#include "TimerWheel.h"
+
+#include "Logger.h"
+
+#include "fmt/format.h"
+#include "fmt/xchar.h"
+
+#include <vector>
+
+using namespace Utilities;
+
+namespace Thread
+{
+	TimerWheel::TimerWheel(const std::chrono::milliseconds& resolution, const std::string& title)
+		: thread_(nullptr)
+		, thread_stop_(false)
+		, title_(title)
+		, resolution_(std::max(resolution, std::chrono::milliseconds(1)))
+		, origin_(std::chrono::steady_clock::now())
+		, tick_(0)
+		, next_id_(1)
+	{
+	}
+
+	TimerWheel::~TimerWheel(void) { stop(); }
+
+	auto TimerWheel::start(void) -> std::tuple<bool, std::optional<std::string>>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		if (thread_ != nullptr)
+		{
+			return { true, std::nullopt };
+		}
+
+		thread_stop_ = false;
+
+		try
+		{
+			thread_ = std::make_unique<std::thread>(&TimerWheel::run, this);
+		}
+		catch (const std::bad_alloc& e)
+		{
+			return { false, "Failed to create thread instance." };
+		}
+
+		Logger::handle().write(LogTypes::Sequence, fmt::format("started {}", title_));
+
+		return { true, std::nullopt };
+	}
+
+	auto TimerWheel::stop(void) -> void
+	{
+		std::unique_ptr<std::thread> target = nullptr;
+		{
+			std::scoped_lock<std::mutex> lock(mutex_);
+
+			thread_stop_ = true;
+			condition_.notify_one();
+
+			target = std::move(thread_);
+		}
+
+		if (target != nullptr && target->joinable())
+		{
+			target->join();
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		for (auto& wheel : wheels_)
+		{
+			for (auto& slot : wheel)
+			{
+				slot.clear();
+			}
+		}
+		timers_.clear();
+	}
+
+	auto TimerWheel::schedule(const std::chrono::milliseconds& delay, const std::chrono::milliseconds& period, const std::function<void(void)>& callback) -> uint64_t
+	{
+		if (!callback)
+		{
+			return 0;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		if (timers_.empty())
+		{
+			tick_ = std::max(tick_, current_tick());
+		}
+
+		// the current tick is already partly elapsed, so one extra tick keeps a timer from firing early
+		auto id = next_id_++;
+		auto expiry = std::max(current_tick() + to_ticks(delay) + 1, tick_ + 1);
+		auto repeat = (period.count() > 0) ? std::max<uint64_t>(to_ticks(period), 1) : 0;
+
+		Slot created;
+		created.push_back({ id, expiry, repeat, 0, 0, std::make_shared<const std::function<void(void)>>(callback) });
+
+		auto timer = created.begin();
+		timers_.insert({ id, timer });
+		place(created, timer);
+
+		condition_.notify_one();
+
+		return id;
+	}
+
+	auto TimerWheel::cancel(const uint64_t& timer_id) -> bool
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto iter = timers_.find(timer_id);
+		if (iter == timers_.end())
+		{
+			return false;
+		}
+
+		auto timer = iter->second;
+		wheels_[timer->level][timer->slot].erase(timer);
+		timers_.erase(iter);
+
+		return true;
+	}
+
+	auto TimerWheel::size(void) -> size_t
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		return timers_.size();
+	}
+
+	auto TimerWheel::run(void) -> void
+	{
+		std::unique_lock<std::mutex> unique(mutex_);
+		while (!thread_stop_)
+		{
+			std::vector<std::shared_ptr<const std::function<void(void)>>> expired;
+			if (timers_.empty())
+			{
+				tick_ = std::max(tick_, current_tick());
+			}
+			else
+			{
+				advance(current_tick(), expired);
+			}
+
+			if (!expired.empty())
+			{
+				unique.unlock();
+
+				for (auto& callback : expired)
+				{
+					try
+					{
+						(*callback)();
+					}
+					catch (const std::exception& message)
+					{
+						Logger::handle().write(LogTypes::Exception, fmt::format("cannot complete a timer on {} : {}", title_, message.what()));
+					}
+					catch (...)
+					{
+						Logger::handle().write(LogTypes::Exception, fmt::format("cannot complete a timer on {} : unexpected error", title_));
+					}
+				}
+
+				unique.lock();
+
+				continue;
+			}
+
+			if (timers_.empty())
+			{
+				condition_.wait(unique, [this]() { return thread_stop_ || !timers_.empty(); });
+
+				continue;
+			}
+
+			condition_.wait_until(unique, origin_ + resolution_ * (tick_ + next_wakeup()));
+		}
+	}
+
+	auto TimerWheel::current_tick(void) const -> uint64_t
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - origin_) / resolution_);
+	}
+
+	auto TimerWheel::to_ticks(const std::chrono::milliseconds& duration) const -> uint64_t
+	{
+		if (duration.count() <= 0)
+		{
+			return 0;
+		}
+
+		return static_cast<uint64_t>((duration + resolution_ - std::chrono::milliseconds(1)) / resolution_);
+	}
+
+	auto TimerWheel::place(Slot& source, Slot::iterator timer) -> void
+	{
+		uint64_t delta = (timer->expiry > tick_) ? timer->expiry - tick_ : 0;
+
+		size_t level = 0;
+		while (level + 1 < TIMER_WHEEL_LEVELS && delta >= (static_cast<uint64_t>(1) << (TIMER_WHEEL_SLOT_BITS * (level + 1))))
+		{
+			level++;
+		}
+
+		timer->level = level;
+		timer->slot = static_cast<size_t>((timer->expiry >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+
+		auto& target = wheels_[timer->level][timer->slot];
+		target.splice(target.end(), source, timer);
+	}
+
+	auto TimerWheel::advance(const uint64_t& target, std::vector<std::shared_ptr<const std::function<void(void)>>>& expired) -> void
+	{
+		while (tick_ < target && !timers_.empty())
+		{
+			tick_++;
+
+			size_t top = 0;
+			while (top + 1 < TIMER_WHEEL_LEVELS && (tick_ & ((static_cast<uint64_t>(1) << (TIMER_WHEEL_SLOT_BITS * (top + 1))) - 1)) == 0)
+			{
+				top++;
+			}
+
+			for (size_t level = top; level > 0; --level)
+			{
+				Slot cascading;
+				cascading.splice(cascading.end(), wheels_[level][(tick_ >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1)]);
+				while (!cascading.empty())
+				{
+					place(cascading, cascading.begin());
+				}
+			}
+
+			Slot expiring;
+			expiring.splice(expiring.end(), wheels_[0][tick_ & (TIMER_WHEEL_SLOTS - 1)]);
+			while (!expiring.empty())
+			{
+				auto timer = expiring.begin();
+				expired.push_back(timer->callback);
+
+				if (timer->period == 0)
+				{
+					timers_.erase(timer->id);
+					expiring.erase(timer);
+
+					continue;
+				}
+
+				timer->expiry = std::max(timer->expiry + timer->period, tick_ + 1);
+				place(expiring, timer);
+			}
+		}
+
+		if (timers_.empty())
+		{
+			tick_ = std::max(tick_, target);
+		}
+	}
+
+	auto TimerWheel::next_wakeup(void) const -> uint64_t
+	{
+		uint64_t until_cascade = TIMER_WHEEL_SLOTS - (tick_ & (TIMER_WHEEL_SLOTS - 1));
+		for (uint64_t distance = 1; distance < until_cascade; ++distance)
+		{
+			if (!wheels_[0][(tick_ + distance) & (TIMER_WHEEL_SLOTS - 1)].empty())
+			{
+				return distance;
+			}
+		}
+
+		return until_cascade;
+	}
+} // namespace Thread
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <list>
+#include <array>
+#include <mutex>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+namespace Thread
+{
+	constexpr size_t TIMER_WHEEL_LEVELS = 4;
+	constexpr size_t TIMER_WHEEL_SLOT_BITS = 8;
+	constexpr size_t TIMER_WHEEL_SLOTS = static_cast<size_t>(1) << TIMER_WHEEL_SLOT_BITS;
+
+	// Hierarchical timing wheel driven by a single thread.
+	// Level 0 covers the next 256 ticks one slot per tick, and each level above covers 256 times more;
+	// timers trickle down a level whenever the level below wraps. Insert and cancel are O(1).
+	class TimerWheel
+	{
+	public:
+		TimerWheel(const std::chrono::milliseconds& resolution = std::chrono::milliseconds(1), const std::string& title = "TimerWheel");
+		virtual ~TimerWheel(void);
+
+		auto start(void) -> std::tuple<bool, std::optional<std::string>>;
+		auto stop(void) -> void;
+
+		auto schedule(const std::chrono::milliseconds& delay, const std::chrono::milliseconds& period, const std::function<void(void)>& callback) -> uint64_t;
+		auto cancel(const uint64_t& timer_id) -> bool;
+
+		auto size(void) -> size_t;
+
+	private:
+		struct Timer
+		{
+			uint64_t id;
+			uint64_t expiry;
+			uint64_t period;
+			size_t level;
+			size_t slot;
+			std::shared_ptr<const std::function<void(void)>> callback;
+		};
+
+		using Slot = std::list<Timer>;
+
+		auto run(void) -> void;
+		auto current_tick(void) const -> uint64_t;
+		auto to_ticks(const std::chrono::milliseconds& duration) const -> uint64_t;
+		auto place(Slot& source, Slot::iterator timer) -> void;
+		auto advance(const uint64_t& target, std::vector<std::shared_ptr<const std::function<void(void)>>>& expired) -> void;
+		auto next_wakeup(void) const -> uint64_t;
+
+	private:
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::unique_ptr<std::thread> thread_;
+		bool thread_stop_;
+
+		std::string title_;
+		std::chrono::milliseconds resolution_;
+		std::chrono::steady_clock::time_point origin_;
+
+		uint64_t tick_;
+		uint64_t next_id_;
+		std::array<std::array<Slot, TIMER_WHEEL_SLOTS>, TIMER_WHEEL_LEVELS> wheels_;
+		std::unordered_map<uint64_t, Slot::iterator> timers_;
+	};
+} // namespace Thread
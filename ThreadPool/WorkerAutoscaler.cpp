@@ -0,0 +1,109 @@
+#include "WorkerAutoscaler.h"
+
+namespace Thread
+{
+	WorkerAutoscaler::WorkerAutoscaler(const AutoscalePolicy& policy) : policy_(policy), started_(false), last_consumed_(0), idle_since_(std::nullopt) {}
+
+	WorkerAutoscaler::~WorkerAutoscaler(void) {}
+
+	auto WorkerAutoscaler::validate(void) const -> std::tuple<bool, std::optional<std::string>>
+	{
+		if (policy_.max_workers == 0)
+		{
+			return { false, "cannot autoscale with zero max workers" };
+		}
+
+		if (policy_.min_workers > policy_.max_workers)
+		{
+			return { false, "cannot autoscale with min workers greater than max workers" };
+		}
+
+		if (policy_.interval.count() <= 0)
+		{
+			return { false, "cannot autoscale with non-positive interval" };
+		}
+
+		return { true, std::nullopt };
+	}
+
+	auto WorkerAutoscaler::policy(void) const -> const AutoscalePolicy& { return policy_; }
+
+	auto WorkerAutoscaler::evaluate(const size_t& workers, const size_t& queued, const uint64_t& consumed) -> size_t
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto now = std::chrono::steady_clock::now();
+		auto elapsed = now - last_check_;
+		auto consumed_delta = consumed - last_consumed_;
+
+		auto first = !started_;
+		started_ = true;
+		last_check_ = now;
+		last_consumed_ = consumed;
+
+		if (workers < policy_.min_workers)
+		{
+			idle_since_ = std::nullopt;
+
+			return policy_.min_workers;
+		}
+
+		if (workers > policy_.max_workers)
+		{
+			return policy_.max_workers;
+		}
+
+		if (first)
+		{
+			return workers;
+		}
+
+		if (queued > 0)
+		{
+			idle_since_ = std::nullopt;
+
+			if (workers < policy_.max_workers && estimated_wait(workers, queued, consumed_delta, elapsed) > policy_.target_wait)
+			{
+				return workers + 1;
+			}
+
+			return workers;
+		}
+
+		if (consumed_delta > 0)
+		{
+			idle_since_ = std::nullopt;
+
+			return workers;
+		}
+
+		if (idle_since_ == std::nullopt)
+		{
+			idle_since_ = now;
+
+			return workers;
+		}
+
+		if (workers <= policy_.min_workers || now - idle_since_.value() < policy_.idle_timeout)
+		{
+			return workers;
+		}
+
+		// restart the idle window so that the lane sheds at most one worker per idle timeout
+		idle_since_ = now;
+
+		return workers - 1;
+	}
+
+	auto WorkerAutoscaler::estimated_wait(const size_t& workers, const size_t& queued, const uint64_t& consumed, const std::chrono::steady_clock::duration& elapsed) const
+		-> std::chrono::steady_clock::duration
+	{
+		if (workers == 0 || consumed == 0)
+		{
+			// nothing drained during the whole interval, so the backlog makes no progress at the current size
+			return std::chrono::steady_clock::duration::max();
+		}
+
+		return elapsed * static_cast<int64_t>(queued) / static_cast<int64_t>(consumed);
+	}
+} // namespace Thread
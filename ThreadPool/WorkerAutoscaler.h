@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mutex>
+#include <tuple>
+#include <chrono>
+#include <string>
+#include <optional>
+
+namespace Thread
+{
+	struct AutoscalePolicy
+	{
+		size_t min_workers;
+		size_t max_workers;
+		std::chrono::milliseconds target_wait;
+		std::chrono::milliseconds idle_timeout;
+		std::chrono::milliseconds interval;
+	};
+
+	// Decides how many workers one priority lane should have.
+	// Queue wait is estimated from the backlog and the consumption rate seen since the last evaluation (Little's law),
+	// so no per-job timestamp is needed. The lane grows by one worker per evaluation while the estimate exceeds the target,
+	// and shrinks by one worker per idle timeout while nothing is queued or consumed.
+	class WorkerAutoscaler
+	{
+	public:
+		WorkerAutoscaler(const AutoscalePolicy& policy);
+		virtual ~WorkerAutoscaler(void);
+
+		auto validate(void) const -> std::tuple<bool, std::optional<std::string>>;
+		auto policy(void) const -> const AutoscalePolicy&;
+
+		auto evaluate(const size_t& workers, const size_t& queued, const uint64_t& consumed) -> size_t;
+
+	private:
+		auto estimated_wait(const size_t& workers, const size_t& queued, const uint64_t& consumed, const std::chrono::steady_clock::duration& elapsed) const
+			-> std::chrono::steady_clock::duration;
+
+	private:
+		std::mutex mutex_;
+		AutoscalePolicy policy_;
+
+		bool started_;
+		uint64_t last_consumed_;
+		std::chrono::steady_clock::time_point last_check_;
+		std::optional<std::chrono::steady_clock::time_point> idle_since_;
+	};
+} // namespace Thread
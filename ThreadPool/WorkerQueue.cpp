@@ -0,0 +1,135 @@
+#include "WorkerQueue.h"
+
+#include "Job.h"
+
+namespace Thread
+{
+	WorkerQueue::WorkerQueue(const std::vector<JobPriorities>& priorities) : job_count_(0), priority_mask_(0) { this->priorities(priorities); }
+
+	WorkerQueue::~WorkerQueue(void) { clear(); }
+
+	auto WorkerQueue::priorities(const std::vector<JobPriorities>& priorities) -> void
+	{
+		uint32_t mask = 0;
+		for (const auto& priority : priorities)
+		{
+			mask |= (1u << static_cast<uint8_t>(priority));
+		}
+
+		priority_mask_.store(mask);
+	}
+
+	auto WorkerQueue::serves(const JobPriorities& priority) -> bool { return (priority_mask_.load(std::memory_order_relaxed) & (1u << static_cast<uint8_t>(priority))) != 0; }
+
+	auto WorkerQueue::push(std::shared_ptr<Job> job) -> void
+	{
+		if (job == nullptr)
+		{
+			return;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		job_queues_[job->priority()].push_back(job);
+		job_count_.fetch_add(1);
+	}
+
+	auto WorkerQueue::pop(const JobPriorities& priority) -> std::shared_ptr<Job>
+	{
+		if (job_count_.load() == 0)
+		{
+			return nullptr;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto iter = job_queues_.find(priority);
+		if (iter == job_queues_.end() || iter->second.empty())
+		{
+			return nullptr;
+		}
+
+		std::shared_ptr<Job> result = iter->second.front();
+		iter->second.pop_front();
+		job_count_.fetch_sub(1);
+
+		return result;
+	}
+
+	auto WorkerQueue::steal(const JobPriorities& priority) -> std::shared_ptr<Job>
+	{
+		if (job_count_.load() == 0)
+		{
+			return nullptr;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto iter = job_queues_.find(priority);
+		if (iter == job_queues_.end() || iter->second.empty())
+		{
+			return nullptr;
+		}
+
+		std::shared_ptr<Job> result = iter->second.back();
+		iter->second.pop_back();
+		job_count_.fetch_sub(1);
+
+		return result;
+	}
+
+	auto WorkerQueue::job_count(const JobPriorities& priority) -> size_t
+	{
+		if (job_count_.load() == 0)
+		{
+			return 0;
+		}
+
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto iter = job_queues_.find(priority);
+		if (iter == job_queues_.end())
+		{
+			return 0;
+		}
+
+		return iter->second.size();
+	}
+
+	auto WorkerQueue::job_count(void) -> size_t { return job_count_.load(); }
+
+	auto WorkerQueue::clear(void) -> std::vector<std::shared_ptr<Job>>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		std::vector<std::shared_ptr<Job>> result;
+		result.reserve(job_count_.load());
+
+		for (auto& [priority, queue] : job_queues_)
+		{
+			result.insert(result.end(), queue.begin(), queue.end());
+		}
+
+		job_queues_.clear();
+		job_count_.store(0);
+
+		return result;
+	}
+
+	auto WorkerQueue::clear(const JobPriorities& priority) -> std::vector<std::shared_ptr<Job>>
+	{
+		std::scoped_lock<std::mutex> lock(mutex_);
+
+		auto iter = job_queues_.find(priority);
+		if (iter == job_queues_.end())
+		{
+			return {};
+		}
+
+		std::vector<std::shared_ptr<Job>> result(iter->second.begin(), iter->second.end());
+		job_count_.fetch_sub(result.size());
+		job_queues_.erase(iter);
+
+		return result;
+	}
+} // namespace Thread
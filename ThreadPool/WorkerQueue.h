@@ -0,0 +1,40 @@
+#pragma once
+
+#include "JobPriorities.h"
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Thread
+{
+	class Job;
+	class WorkerQueue
+	{
+	public:
+		WorkerQueue(const std::vector<JobPriorities>& priorities);
+		virtual ~WorkerQueue(void);
+
+		auto priorities(const std::vector<JobPriorities>& priorities) -> void;
+		auto serves(const JobPriorities& priority) -> bool;
+
+		auto push(std::shared_ptr<Job> job) -> void;
+		auto pop(const JobPriorities& priority) -> std::shared_ptr<Job>;
+		auto steal(const JobPriorities& priority) -> std::shared_ptr<Job>;
+
+		auto job_count(const JobPriorities& priority) -> size_t;
+		auto job_count(void) -> size_t;
+
+		auto clear(void) -> std::vector<std::shared_ptr<Job>>;
+		auto clear(const JobPriorities& priority) -> std::vector<std::shared_ptr<Job>>;
+
+	private:
+		std::mutex mutex_;
+		std::atomic<size_t> job_count_;
+		std::atomic<uint32_t> priority_mask_;
+		std::map<JobPriorities, std::deque<std::shared_ptr<Job>>> job_queues_;
+	};
+} // namespace Thread
@@ -23,6 +23,6 @@ REM Upgrade any installed packages
 vcpkg upgrade --no-dry-run
 
 REM Install packages with the specified triplet
-vcpkg install "lz4" "fmt" "cryptopp" "redis-plus-plus" "gtest" "libpq" "efsw" "boost-algorithm" "boost-dll" "boost-asio" "boost-json" "boost-system" "boost-container" "boost-filesystem" "boost-process" "sndfile" "libsamplerate" "curl" "cpp-httplib[openssl]" "aws-sdk-cpp[ssm]" "librabbitmq" --triplet x64-windows --recurse
+vcpkg install "lz4" "fmt" "cryptopp" "redis-plus-plus" "gtest" "benchmark" "libpq" "efsw" "boost-algorithm" "boost-dll" "boost-asio" "boost-json" "boost-system" "boost-container" "boost-filesystem" "boost-process" "sndfile" "libsamplerate" "curl" "cpp-httplib[openssl]" "aws-sdk-cpp[ssm]" "librabbitmq" --triplet x64-windows --recurse
 
 popd
\ No newline at end of file
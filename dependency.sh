@@ -17,7 +17,7 @@ if [ "$(uname)" == "Darwin" ]; then
     ./bootstrap-vcpkg.sh
     ./vcpkg integrate install
     ./vcpkg upgrade --no-dry-run
-    ./vcpkg install 'lz4' 'fmt' 'cryptopp' 'redis-plus-plus' 'gtest' 'libpq' 'efsw' 'boost-algorithm' 'boost-dll' 'boost-asio' 'boost-json' 'boost-system' 'boost-container' 'boost-filesystem' 'sndfile' 'libsamplerate' 'curl' 'cpp-httplib[openssl]' 'aws-sdk-cpp[ssm]' 'librabbitmq' --recurse
+    ./vcpkg install 'lz4' 'fmt' 'cryptopp' 'redis-plus-plus' 'gtest' 'benchmark' 'libpq' 'efsw' 'boost-algorithm' 'boost-dll' 'boost-asio' 'boost-json' 'boost-system' 'boost-container' 'boost-filesystem' 'sndfile' 'libsamplerate' 'curl' 'cpp-httplib[openssl]' 'aws-sdk-cpp[ssm]' 'librabbitmq' --recurse
 
     cd ..
 
@@ -55,7 +55,7 @@ if [ "$(uname)" == "Linux" ]; then
     ./bootstrap-vcpkg.sh
     ./vcpkg integrate install
     ./vcpkg upgrade --no-dry-run
-    ./vcpkg install 'lz4' 'fmt' 'cryptopp' 'redis-plus-plus' 'gtest' 'libpq' 'efsw' 'boost-algorithm' 'boost-dll' 'boost-asio' 'boost-json' 'boost-system' 'boost-container' 'boost-filesystem' 'sndfile' 'libsamplerate' 'curl' 'cpp-httplib[openssl]' 'aws-sdk-cpp[ssm]' 'librabbitmq' --recurse
+    ./vcpkg install 'lz4' 'fmt' 'cryptopp' 'redis-plus-plus' 'gtest' 'benchmark' 'libpq' 'efsw' 'boost-algorithm' 'boost-dll' 'boost-asio' 'boost-json' 'boost-system' 'boost-container' 'boost-filesystem' 'sndfile' 'libsamplerate' 'curl' 'cpp-httplib[openssl]' 'aws-sdk-cpp[ssm]' 'librabbitmq' --recurse
 
     cd ..
 